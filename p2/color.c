@@ -0,0 +1,394 @@
+/**
+ * @file color.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * single channel images and fixed point color space conversions
+ */
+#include "color.h"
+
+#include "image.h"
+#include "pool.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * max rgb value
+ */
+#define MAX_RGB 255
+/**
+ * fixed point fraction bits for the color weights
+ */
+#define SHIFT 8
+/**
+ * one half in fixed point, for rounding
+ */
+#define ROUND (1 << (SHIFT - 1))
+/**
+ * chroma offset of Cb and Cr
+ */
+#define CHROMA 128
+
+/**
+ * BT.601 luma weights scaled by 256
+ */
+#define Y_R 77
+#define Y_G 150
+#define Y_B 29
+
+/**
+ * BT.601 Cb weights scaled by 256
+ */
+#define CB_R -43
+#define CB_G -85
+#define CB_B 128
+
+/**
+ * BT.601 Cr weights scaled by 256
+ */
+#define CR_R 128
+#define CR_G -107
+#define CR_B -21
+
+/**
+ * BT.601 inverse weights scaled by 256
+ */
+#define R_CR 359
+#define G_CB 88
+#define G_CR 183
+#define B_CB 454
+
+/**
+ * @brief create a gray image
+ * @param magic_number value for the gray image, P2 or P5
+ * @param height value for the gray image
+ * @param width value for the gray image
+ * @param max_intensity value for the gray image
+ * @return the created gray image
+ */
+GrayImage
+gray_create(const char* magic_number,
+            const int height,
+            const int width,
+            const int max_intensity)
+{
+    GrayImage image;
+    image.height = height;
+    image.width = width;
+    image.max_intensity = max_intensity;
+
+    strncpy(image.magic_number, magic_number, MAGIC_NUMBER_LENGTH);
+
+    image.data = (int**) pool_alloc(height * sizeof(int*));
+    int* pixels = height > 0 ? (int*) pool_alloc((size_t) height * width *
+                                                 sizeof(int))
+                             : NULL;
+
+    for (int i = 0; i < height; i++) {
+        image.data[i] = pixels + (size_t) i * width;
+    }
+    return image;
+}
+
+/**
+ * @brief destroy a gray image
+ * @param image being destroyed
+ */
+void
+gray_destroy(GrayImage* image)
+{
+    if (image->data == NULL) {
+        return;
+    }
+    if (image->height > 0) {
+        pool_free(image->data[0]);
+    }
+    pool_free(image->data);
+    image->data = NULL;
+}
+
+/**
+ * @brief convolves the gray image at the provided point
+ * @param image being convolved
+ * @param kern performing the convolution
+ * @param i of the point
+ * @param j of the point
+ * @param normalize boolean value if the convolve is normalized or not
+ * @return the convolved value
+ */
+static int
+gray_convolve_at_point(GrayImage* image,
+                       GrayImage* kern,
+                       int i,
+                       int j,
+                       bool normalize)
+{
+    const int min_height = i - kern->height / 2;
+    const int min_width = j - kern->width / 2;
+
+    int sum = 0;
+    int kern_sum = 0;
+
+    for (int kern_i = 0; kern_i < kern->height; kern_i++) {
+        const int img_i = min_height + kern_i;
+
+        if (!in_range(img_i, 0, image->height)) {
+            continue;
+        }
+        for (int kern_j = 0; kern_j < kern->width; kern_j++) {
+            const int img_j = min_width + kern_j;
+
+            if (in_range(img_j, 0, image->width)) {
+                kern_sum += kern->data[kern_i][kern_j];
+                sum += image->data[img_i][img_j] * kern->data[kern_i][kern_j];
+            }
+        }
+    }
+
+    // A kernel summing to zero, such as an edge kernel, is left as it is.
+    if (normalize && kern_sum != 0) {
+        sum /= kern_sum;
+    }
+    return sum;
+}
+
+/**
+ * @brief convolves the gray image, the single channel version of
+ * image_convolve
+ * @param image being convolved
+ * @param kernel performing the convolution
+ * @param normalize boolean value if the convolve is normalized or not
+ * @return the convolved image
+ */
+GrayImage*
+gray_convolve(GrayImage* image, GrayImage* kernel, bool normalize)
+{
+    GrayImage copy = gray_create(
+      image->magic_number, image->height, image->width, image->max_intensity);
+
+    for (int i = 0; i < image->height; i++) {
+        for (int j = 0; j < image->width; j++) {
+            copy.data[i][j] =
+              gray_convolve_at_point(image, kernel, i, j, normalize);
+        }
+    }
+
+    for (int i = 0; i < image->height; i++) {
+        memcpy(image->data[i], copy.data[i], image->width * sizeof(int));
+    }
+    gray_destroy(&copy);
+
+    return image;
+}
+
+/**
+ * @brief create a gray image from an array
+ * @param height of the image
+ * @param width of the image
+ * @param arr values of the image
+ * @return the created image
+ */
+GrayImage
+gray_from_array(const int height, const int width, double arr[height][width])
+{
+    GrayImage image = gray_create("P2", height, width, MAX_RGB);
+
+    for (int i = 0; i < height; i++) {
+        for (int j = 0; j < width; j++) {
+            image.data[i][j] = (int) arr[i][j];
+        }
+    }
+    return image;
+}
+
+/**
+ * @brief sample function for image_write over a gray image
+ * @param image the GrayImage
+ * @param i row of the pixel
+ * @param j column of the pixel
+ * @param c channel, always 0
+ * @return the pixel value
+ */
+static int
+gray_sample(const void* image, int i, int j, int c)
+{
+    return ((const GrayImage*) image)->data[i][j];
+}
+
+/**
+ * @brief print the gray image as a pgm, through the same writer as image_print
+ * @param image being printed
+ * @param fp where the image is being written
+ */
+void
+gray_print(GrayImage* image, FILE* fp)
+{
+    image_write(fp,
+                image->magic_number,
+                image->height,
+                image->width,
+                image->max_intensity,
+                1,
+                gray_sample,
+                image);
+}
+
+/**
+ * @brief fixed point luma of one pixel
+ * @param rgb being converted
+ * @return the luma
+ */
+static int
+rgb_luma(const RGB* rgb)
+{
+    return (Y_R * rgb->red + Y_G * rgb->green + Y_B * rgb->blue + ROUND) >>
+           SHIFT;
+}
+
+/**
+ * @brief luma of an image using BT.601 fixed point weights
+ * @param image being converted
+ * @return the luma image, P2
+ */
+GrayImage
+image_to_gray(PPMImage* image)
+{
+    GrayImage gray =
+      gray_create("P2", image->height, image->width, image->max_intensity);
+
+    for (int i = 0; i < image->height; i++) {
+        const RGB* row = image->data[i];
+        int* out = gray.data[i];
+
+        for (int j = 0; j < image->width; j++) {
+            out[j] = rgb_luma(&row[j]);
+        }
+    }
+    return gray;
+}
+
+/**
+ * @brief expands a gray image to rgb with every channel equal to the luma
+ * @param image being converted
+ * @return the rgb image, P3
+ */
+PPMImage
+gray_to_image(GrayImage* image)
+{
+    PPMImage out =
+      image_create("P3", image->height, image->width, image->max_intensity);
+
+    for (int i = 0; i < image->height; i++) {
+        for (int j = 0; j < image->width; j++) {
+            const int v = image->data[i][j];
+            out.data[i][j] = (RGB){.red = v, .green = v, .blue = v};
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief converts an rgb image to YCbCr in place using BT.601 fixed point
+ * weights. Y is stored in red, Cb in green and Cr in blue
+ * @param image being converted
+ * @return the converted image
+ */
+PPMImage*
+image_rgb_to_ycbcr(PPMImage* image)
+{
+    for (int i = 0; i < image->height; i++) {
+        RGB* row = image->data[i];
+
+        for (int j = 0; j < image->width; j++) {
+            const int r = row[j].red;
+            const int g = row[j].green;
+            const int b = row[j].blue;
+
+            RGB ycc = {
+              .red = rgb_luma(&row[j]),
+              .green = ((CB_R * r + CB_G * g + CB_B * b + ROUND) >> SHIFT) +
+                       CHROMA,
+              .blue = ((CR_R * r + CR_G * g + CR_B * b + ROUND) >> SHIFT) +
+                      CHROMA};
+            row[j] = *rgb_clamp(&ycc, 0, image->max_intensity);
+        }
+    }
+    return image;
+}
+
+/**
+ * @brief converts a YCbCr image from image_rgb_to_ycbcr back to rgb in place
+ * @param image being converted
+ * @return the converted image
+ */
+PPMImage*
+image_ycbcr_to_rgb(PPMImage* image)
+{
+    for (int i = 0; i < image->height; i++) {
+        RGB* row = image->data[i];
+
+        for (int j = 0; j < image->width; j++) {
+            const int y = row[j].red;
+            const int cb = row[j].green - CHROMA;
+            const int cr = row[j].blue - CHROMA;
+
+            RGB rgb = {
+              .red = y + ((R_CR * cr + ROUND) >> SHIFT),
+              .green = y - ((G_CB * cb + G_CR * cr + ROUND) >> SHIFT),
+              .blue = y + ((B_CB * cb + ROUND) >> SHIFT)};
+            row[j] = *rgb_clamp(&rgb, 0, image->max_intensity);
+        }
+    }
+    return image;
+}
+
+/**
+ * @brief splits an image into red, green and blue planes
+ * @param image being split
+ * @param planes receives the DEPTH planes
+ */
+void
+image_to_planes(PPMImage* image, GrayImage planes[DEPTH])
+{
+    for (int c = 0; c < DEPTH; c++) {
+        planes[c] =
+          gray_create("P2", image->height, image->width, image->max_intensity);
+    }
+
+    for (int i = 0; i < image->height; i++) {
+        const RGB* row = image->data[i];
+        int* red = planes[0].data[i];
+        int* green = planes[1].data[i];
+        int* blue = planes[2].data[i];
+
+        for (int j = 0; j < image->width; j++) {
+            red[j] = row[j].red;
+            green[j] = row[j].green;
+            blue[j] = row[j].blue;
+        }
+    }
+}
+
+/**
+ * @brief joins red, green and blue planes into an image
+ * @param planes the DEPTH planes, all the same size
+ * @return the joined image, P3
+ */
+PPMImage
+image_from_planes(GrayImage planes[DEPTH])
+{
+    PPMImage out = image_create(
+      "P3", planes[0].height, planes[0].width, planes[0].max_intensity);
+
+    for (int i = 0; i < out.height; i++) {
+        RGB* row = out.data[i];
+
+        for (int j = 0; j < out.width; j++) {
+            row[j] = (RGB){.red = planes[0].data[i][j],
+                           .green = planes[1].data[i][j],
+                           .blue = planes[2].data[i][j]};
+        }
+    }
+    return out;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file color.h
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * single channel images and fixed point color space conversions
+ */
+#ifndef color_h
+#define color_h
+
+#include "image.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * single channel image struct of magic number, height, width, max_intensity,
+ * data (2 d array)
+ */
+typedef struct {
+    char magic_number[MAGIC_NUMBER_LENGTH];
+    int height;
+    int width;
+    int max_intensity;
+    int** data;
+} GrayImage;
+
+/**
+ * @brief create a gray image
+ * @param magic_number value for the gray image, P2 or P5
+ * @param height value for the gray image
+ * @param width value for the gray image
+ * @param max_intensity value for the gray image
+ * @return the created gray image
+ */
+GrayImage
+gray_create(const char* magic_number,
+            const int height,
+            const int width,
+            const int max_intensity);
+
+/**
+ * @brief destroy a gray image
+ * @param image being destroyed
+ */
+void
+gray_destroy(GrayImage* image);
+
+/**
+ * @brief convolves the gray image, the single channel version of
+ * image_convolve
+ * @param image being convolved
+ * @param kernel performing the convolution
+ * @param normalize boolean value if the convolve is normalized or not
+ * @return the convolved image
+ */
+GrayImage*
+gray_convolve(GrayImage* image, GrayImage* kernel, bool normalize);
+
+/**
+ * @brief create a gray image from an array
+ * @param height of the image
+ * @param width of the image
+ * @param arr values of the image
+ * @return the created image
+ */
+GrayImage
+gray_from_array(const int height, const int width, double arr[height][width]);
+
+/**
+ * @brief print the gray image as a pgm, through the same writer as image_print
+ * @param image being printed
+ * @param fp where the image is being written
+ */
+void
+gray_print(GrayImage* image, FILE* fp);
+
+/**
+ * @brief luma of an image using BT.601 fixed point weights
+ * @param image being converted
+ * @return the luma image, P2
+ */
+GrayImage
+image_to_gray(PPMImage* image);
+
+/**
+ * @brief expands a gray image to rgb with every channel equal to the luma
+ * @param image being converted
+ * @return the rgb image, P3
+ */
+PPMImage
+gray_to_image(GrayImage* image);
+
+/**
+ * @brief converts an rgb image to YCbCr in place using BT.601 fixed point
+ * weights. Y is stored in red, Cb in green and Cr in blue
+ * @param image being converted
+ * @return the converted image
+ */
+PPMImage*
+image_rgb_to_ycbcr(PPMImage* image);
+
+/**
+ * @brief converts a YCbCr image from image_rgb_to_ycbcr back to rgb in place
+ * @param image being converted
+ * @return the converted image
+ */
+PPMImage*
+image_ycbcr_to_rgb(PPMImage* image);
+
+/**
+ * @brief splits an image into red, green and blue planes
+ * @param image being split
+ * @param planes receives the DEPTH planes
+ */
+void
+image_to_planes(PPMImage* image, GrayImage planes[DEPTH]);
+
+/**
+ * @brief joins red, green and blue planes into an image
+ * @param planes the DEPTH planes, all the same size
+ * @return the joined image, P3
+ */
+PPMImage
+image_from_planes(GrayImage planes[DEPTH]);
+
+#endif
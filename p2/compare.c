@@ -0,0 +1,240 @@
+/**
+ * @file compare.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * compares two ppm images with exact, error, psnr and ssim metrics
+ */
+#include "compare.h"
+
+#include "image.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * ssim luminance stabilizer, scaled by the max intensity
+ */
+#define SSIM_K1 0.01
+/**
+ * ssim contrast stabilizer, scaled by the max intensity
+ */
+#define SSIM_K2 0.03
+/**
+ * psnr decibel multiplier
+ */
+#define DECIBELS 10.0
+
+/**
+ * @brief checks two images for an exact match, stopping at the first row
+ * that differs
+ * @param a first image
+ * @param b second image
+ * @return true if the sizes, max intensities and every pixel match
+ */
+bool
+image_equal(PPMImage* a, PPMImage* b)
+{
+    if (a->height != b->height || a->width != b->width ||
+        a->max_intensity != b->max_intensity) {
+        return false;
+    }
+    for (int i = 0; i < a->height; i++) {
+        if (memcmp(a->data[i], b->data[i], a->width * sizeof(RGB)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * partial sums for one band of rows
+ */
+typedef struct {
+    PPMImage* a;
+    PPMImage* b;
+    int row_start;
+    int row_end;
+    int window_start;
+    int window_end;
+    int window_height;
+    int window_width;
+
+    int max_error;
+    double squared_error;
+    double ssim_sum;
+    int ssim_count;
+} CompareJob;
+
+/**
+ * @brief value of channel c of a pixel
+ * @param rgb the pixel
+ * @param c channel, 0 red, 1 green, 2 blue
+ * @return the channel value
+ */
+static int
+channel(const RGB* rgb, int c)
+{
+    switch (c) {
+        case 0:
+            return rgb->red;
+        case 1:
+            return rgb->green;
+        default:
+            return rgb->blue;
+    }
+}
+
+/**
+ * @brief ssim of one channel of one window
+ * @param job with the images and window size
+ * @param top row of the window
+ * @param left column of the window
+ * @param c channel
+ * @return the window ssim
+ */
+static double
+window_ssim(const CompareJob* job, int top, int left, int c)
+{
+    const double range = job->a->max_intensity;
+    const double c1 = (SSIM_K1 * range) * (SSIM_K1 * range);
+    const double c2 = (SSIM_K2 * range) * (SSIM_K2 * range);
+    const double n = job->window_height * job->window_width;
+
+    double sum_a = 0;
+    double sum_b = 0;
+    double sum_aa = 0;
+    double sum_bb = 0;
+    double sum_ab = 0;
+
+    for (int i = top; i < top + job->window_height; i++) {
+        const RGB* row_a = job->a->data[i];
+        const RGB* row_b = job->b->data[i];
+
+        for (int j = left; j < left + job->window_width; j++) {
+            const double x = channel(&row_a[j], c);
+            const double y = channel(&row_b[j], c);
+
+            sum_a += x;
+            sum_b += y;
+            sum_aa += x * x;
+            sum_bb += y * y;
+            sum_ab += x * y;
+        }
+    }
+
+    const double mean_a = sum_a / n;
+    const double mean_b = sum_b / n;
+    const double var_a = sum_aa / n - mean_a * mean_a;
+    const double var_b = sum_bb / n - mean_b * mean_b;
+    const double cov = sum_ab / n - mean_a * mean_b;
+
+    return ((2 * mean_a * mean_b + c1) * (2 * cov + c2)) /
+           ((mean_a * mean_a + mean_b * mean_b + c1) * (var_a + var_b + c2));
+}
+
+/**
+ * @brief reduces error and ssim over the job's band
+ * @param arg the CompareJob
+ * @return NULL
+ */
+static void*
+compare_rows(void* arg)
+{
+    CompareJob* job = arg;
+
+    for (int i = job->row_start; i < job->row_end; i++) {
+        const RGB* row_a = job->a->data[i];
+        const RGB* row_b = job->b->data[i];
+
+        for (int j = 0; j < job->a->width; j++) {
+            for (int c = 0; c < DEPTH; c++) {
+                const int error =
+                  abs(channel(&row_a[j], c) - channel(&row_b[j], c));
+
+                job->max_error = imax(job->max_error, error);
+                job->squared_error += (double) error * error;
+            }
+        }
+    }
+
+    for (int w = job->window_start; w < job->window_end; w++) {
+        const int top = w * SSIM_STEP;
+
+        for (int left = 0; left + job->window_width <= job->a->width;
+             left += SSIM_STEP) {
+            for (int c = 0; c < DEPTH; c++) {
+                job->ssim_sum += window_ssim(job, top, left, c);
+                job->ssim_count += 1;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief computes max absolute error, mse, psnr and mean windowed ssim over
+ * all three channels, with the rows split into bands across threads
+ * @param a first image
+ * @param b second image, the same size and max intensity as a
+ * @param threads number of worker threads
+ * @return the metrics, psnr is infinite when the images match
+ */
+ImageStats
+image_compare(PPMImage* a, PPMImage* b, int threads)
+{
+    const int window_height = imin(SSIM_WINDOW, a->height);
+    const int window_width = imin(SSIM_WINDOW, a->width);
+    const int window_rows = (a->height - window_height) / SSIM_STEP + 1;
+
+    threads = clamp(threads, 1, a->height);
+
+    pthread_t workers[threads];
+    CompareJob jobs[threads];
+
+    for (int t = 0; t < threads; t++) {
+        jobs[t] = (CompareJob){.a = a,
+                               .b = b,
+                               .row_start = a->height * t / threads,
+                               .row_end = a->height * (t + 1) / threads,
+                               .window_start = window_rows * t / threads,
+                               .window_end = window_rows * (t + 1) / threads,
+                               .window_height = window_height,
+                               .window_width = window_width,
+                               .max_error = 0,
+                               .squared_error = 0,
+                               .ssim_sum = 0,
+                               .ssim_count = 0};
+    }
+
+    // The calling thread takes the first band itself.
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&workers[t], NULL, compare_rows, &jobs[t]) != 0) {
+            compare_rows(&jobs[t]);
+            workers[t] = pthread_self();
+        }
+    }
+    compare_rows(&jobs[0]);
+
+    ImageStats stats = {.max_error = 0, .mse = 0, .psnr = 0, .ssim = 0};
+    int ssim_count = 0;
+
+    for (int t = 0; t < threads; t++) {
+        if (t > 0 && !pthread_equal(workers[t], pthread_self())) {
+            pthread_join(workers[t], NULL);
+        }
+        stats.max_error = imax(stats.max_error, jobs[t].max_error);
+        stats.mse += jobs[t].squared_error;
+        stats.ssim += jobs[t].ssim_sum;
+        ssim_count += jobs[t].ssim_count;
+    }
+
+    stats.mse /= (double) a->height * a->width * DEPTH;
+    stats.ssim /= ssim_count;
+
+    const double range = a->max_intensity;
+    stats.psnr = stats.mse == 0 ? INFINITY
+                                : DECIBELS * log10(range * range / stats.mse);
+
+    return stats;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file compare.h
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * compares two ppm images with exact, error, psnr and ssim metrics
+ */
+#ifndef compare_h
+#define compare_h
+
+#include "image.h"
+
+#include <stdbool.h>
+
+/**
+ * side length of the ssim window
+ */
+#define SSIM_WINDOW 8
+
+/**
+ * step between ssim windows
+ */
+#define SSIM_STEP 4
+
+/**
+ * difference metrics between two images of the same size and max intensity
+ */
+typedef struct {
+    int max_error;
+    double mse;
+    double psnr;
+    double ssim;
+} ImageStats;
+
+/**
+ * @brief checks two images for an exact match, stopping at the first row
+ * that differs
+ * @param a first image
+ * @param b second image
+ * @return true if the sizes, max intensities and every pixel match
+ */
+bool
+image_equal(PPMImage* a, PPMImage* b);
+
+/**
+ * @brief computes max absolute error, mse, psnr and mean windowed ssim over
+ * all three channels, with the rows split into bands across threads
+ * @param a first image
+ * @param b second image, the same size and max intensity as a
+ * @param threads number of worker threads
+ * @return the metrics, psnr is infinite when the images match
+ */
+ImageStats
+image_compare(PPMImage* a, PPMImage* b, int threads);
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file edge.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * performs sobel edge detection on an image
+ */
+#include "image.h"
+#include "parser.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * The kernel size.
+ */
+#define SZ 3
+/**
+ * number of sobel kernels
+ */
+#define KERNEL_COUNT 2
+/**
+ * minimum rgb pixel value
+ */
+#define MIN 0
+/**
+ * maximum rgb pixel value
+ */
+#define MAX 255
+
+/**
+ * @brief computes the sobel gradient magnitude of the ppm image
+ * @return 100 if the ppm header is not p3 or if the ppm max intensity is not
+ * 255 or if width or height in the ppm is less than or equal to 0 101 if there
+ * is any invalid values in the pixel values for the image EXIT_SUCCESS if the
+ * edges are found successfully
+ */
+int
+main()
+{
+    FILE* in_file = stdin;
+    FILE* out_file = stdout;
+
+    PPMImage img = parse_ppm(in_file);
+
+    double sobel_x[SZ][SZ] = {{-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1}};
+    double sobel_y[SZ][SZ] = {{-1, -2, -1}, {0, 0, 0}, {1, 2, 1}};
+
+    PPMImage kernels[KERNEL_COUNT] = {image_from_array(SZ, SZ, sobel_x),
+                                      image_from_array(SZ, SZ, sobel_y)};
+
+    image_convolve_multi(&img, kernels, KERNEL_COUNT, COMBINE_MAGNITUDE);
+
+    for (int i = 0; i < img.height; i++) {
+        for (int j = 0; j < img.width; j++) {
+            rgb_clamp(&img.data[i][j], MIN, MAX);
+        }
+    }
+    image_print(&img, out_file);
+
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        image_destroy(&kernels[k]);
+    }
+    image_destroy(&img);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file gray.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * converts a ppm image to a grayscale pgm image, or runs one of the color
+ * conversions over it
+ */
+#include "color.h"
+#include "image.h"
+#include "parser.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The kernel size.
+ */
+#define SZ 3
+/**
+ * center weight of the gaussian kernel
+ */
+#define GAUSS_MAX 4
+
+/**
+ * @brief blurs each color plane of the image on its own with the gaussian
+ * kernel and joins the planes back into an image
+ * @param image being blurred
+ * @return the blurred image
+ */
+static PPMImage
+blur_planes(PPMImage* image)
+{
+    double arr[SZ][SZ] = {{1, 2, 1}, {2, GAUSS_MAX, 2}, {1, 2, 1}};
+    GrayImage kernel = gray_from_array(SZ, SZ, arr);
+    GrayImage planes[DEPTH];
+
+    image_to_planes(image, planes);
+    for (int c = 0; c < DEPTH; c++) {
+        gray_convolve(&planes[c], &kernel, true);
+    }
+    PPMImage out = image_from_planes(planes);
+
+    for (int c = 0; c < DEPTH; c++) {
+        gray_destroy(&planes[c]);
+    }
+    gray_destroy(&kernel);
+    return out;
+}
+
+/**
+ * @brief converts the ppm image on stdin to its luma and writes it to stdout
+ * as an ascii pgm, or a binary pgm when given the argument "binary". "ycbcr"
+ * writes the image converted to YCbCr, "rgb" writes it converted to YCbCr and
+ * back, and "planes" writes it with each color plane blurred
+ * @param argc number of arguments
+ * @param argv optional "binary", "ycbcr", "rgb" or "planes"
+ * @return 100 if the ppm header is not p3 or if the ppm max intensity is not
+ * 255 or if width or height in the ppm is less than or equal to 0 101 if there
+ * is any invalid values in the pixel values for the image EXIT_SUCCESS if the
+ * image is converted successfully
+ */
+int
+main(int argc, char* argv[])
+{
+    FILE* in_file = stdin;
+    FILE* out_file = stdout;
+
+    PPMImage img = parse_ppm(in_file);
+    const char* mode = argc > 1 ? argv[1] : "";
+
+    if (strcmp(mode, "ycbcr") == 0 || strcmp(mode, "rgb") == 0) {
+        image_rgb_to_ycbcr(&img);
+        if (strcmp(mode, "rgb") == 0) {
+            image_ycbcr_to_rgb(&img);
+        }
+        image_print(&img, out_file);
+    } else if (strcmp(mode, "planes") == 0) {
+        PPMImage out = blur_planes(&img);
+        image_print(&out, out_file);
+        image_destroy(&out);
+    } else {
+        GrayImage gray = image_to_gray(&img);
+
+        if (strcmp(mode, "binary") == 0) {
+            strcpy(gray.magic_number, "P5");
+        }
+        gray_print(&gray, out_file);
+        gray_destroy(&gray);
+    }
+
+    image_destroy(&img);
+
+    return EXIT_SUCCESS;
+}
@@ -5,6 +5,7 @@
  */
 #include "image.h"
 #include "parser.h"
+#include "pool.h"
 
 #include <math.h>
 #include <stdbool.h>
@@ -40,6 +41,10 @@ double GAUSSIAN[GAUSS_VAL][GAUSS_VAL] = {{1, 2, 1}, {2, GAUSS_MAX, 2}, {1, 2, 1}
  * pi value
  */
 #define M_PI_LOCAL 3.14
+/**
+ * second magic number character from which formats are binary (P4, P5, P6)
+ */
+#define BINARY_MAGIC '4'
 
 /**
  * @brief clamp x between two values min and max
@@ -266,7 +271,7 @@ rgb_div_vector(const RGB* rgb1, const RGB* rgb2, RGB* rgb_out)
  * @reutn the created ppm image
  */
 PPMImage
-image_create(const char magic_number[MAGIC_NUMBER_LENGTH],
+image_create(const char* magic_number,
              const int height,
              const int width,
              const int max_intensity)
@@ -278,10 +283,14 @@ image_create(const char magic_number[MAGIC_NUMBER_LENGTH],
 
     strncpy(image.magic_number, magic_number, MAGIC_NUMBER_LENGTH);
 
-    image.data = (RGB**) malloc(height * sizeof(RGB*));
+    // One pooled block for the pixels, so same size images reuse it.
+    image.data = (RGB**) pool_alloc(height * sizeof(RGB*));
+    RGB* pixels = height > 0 ? (RGB*) pool_alloc((size_t) height * width *
+                                                 sizeof(RGB))
+                             : NULL;
 
     for (int i = 0; i < height; i++) {
-        image.data[i] = (RGB*) malloc(width * sizeof(RGB));
+        image.data[i] = pixels + (size_t) i * width;
     };
     return image;
 }
@@ -293,10 +302,13 @@ image_create(const char magic_number[MAGIC_NUMBER_LENGTH],
 void
 image_destroy(PPMImage* image)
 {
-    for (int i = 0; i < image->height; i++) {
-        free(image->data[i]);
-    };
-    free(image->data);
+    if (image->data == NULL) {
+        return;
+    }
+    if (image->height > 0) {
+        pool_free(image->data[0]);
+    }
+    pool_free(image->data);
     image->data = NULL;
     image = NULL;
 }
@@ -449,6 +461,149 @@ image_convolve(PPMImage* image, PPMImage* kernel, bool normalize)
     return image;
 }
 
+/**
+ * @brief combines a single channel of the per kernel sums
+ * @param values channel value from each kernel
+ * @param count number of kernels
+ * @param combine how the values are combined
+ * @return the combined channel value
+ */
+static int
+combine_channel(const int values[], int count, Combine combine)
+{
+    int out = 0;
+
+    switch (combine) {
+        case COMBINE_MAGNITUDE: {
+            double sum = 0;
+            for (int k = 0; k < count; k++) {
+                sum += (double) values[k] * values[k];
+            }
+            out = (int) sqrt(sum);
+            break;
+        }
+        case COMBINE_MAX:
+            out = values[0];
+            for (int k = 1; k < count; k++) {
+                out = imax(out, values[k]);
+            }
+            break;
+        case COMBINE_SUM:
+            for (int k = 0; k < count; k++) {
+                out += values[k];
+            }
+            break;
+    }
+    return out;
+}
+
+/**
+ * @brief convolves the rgb at the provided point with several kernels at once,
+ * reading each neighbor only once
+ * @param image being convolved
+ * @param kernels performing the convolution, all the same size
+ * @param kernel_count number of kernels
+ * @param i of the point
+ * @param j of the point
+ * @param combine how the kernel results are combined
+ * @return the combined rgb value
+ */
+static RGB
+image_convolve_multi_at_point(PPMImage* image,
+                              PPMImage kernels[],
+                              int kernel_count,
+                              int i,
+                              int j,
+                              Combine combine)
+{
+    const int min_height = i - kernels[0].height / 2;
+    const int min_width = j - kernels[0].width / 2;
+
+    RGB sums[kernel_count];
+    for (int k = 0; k < kernel_count; k++) {
+        sums[k] = (RGB){0, 0, 0};
+    }
+
+    for (int kern_i = 0; kern_i < kernels[0].height; kern_i++) {
+        const int img_i = min_height + kern_i;
+
+        if (!in_range(img_i, 0, image->height)) {
+            continue;
+        }
+        for (int kern_j = 0; kern_j < kernels[0].width; kern_j++) {
+            const int img_j = min_width + kern_j;
+
+            if (!in_range(img_j, 0, image->width)) {
+                continue;
+            }
+            const RGB img_rgb = image->data[img_i][img_j];
+
+            for (int k = 0; k < kernel_count; k++) {
+                const RGB kern_rgb = kernels[k].data[kern_i][kern_j];
+                RGB tmp = {0, 0, 0};
+
+                rgb_mult_vector(&img_rgb, &kern_rgb, &tmp);
+                rgb_add_vector(&sums[k], &tmp, &sums[k]);
+            }
+        }
+    }
+
+    int reds[kernel_count];
+    int greens[kernel_count];
+    int blues[kernel_count];
+
+    for (int k = 0; k < kernel_count; k++) {
+        reds[k] = sums[k].red;
+        greens[k] = sums[k].green;
+        blues[k] = sums[k].blue;
+    }
+
+    RGB out = {.red = combine_channel(reds, kernel_count, combine),
+               .green = combine_channel(greens, kernel_count, combine),
+               .blue = combine_channel(blues, kernel_count, combine)};
+    return out;
+}
+
+/**
+ * @brief convolves the image with several kernels in a single pass and
+ * combines the results per pixel
+ * @param image being convolved
+ * @param kernels performing the convolution, all the same size
+ * @param kernel_count number of kernels
+ * @param combine how the kernel results are combined
+ * @return the convolved image, or NULL if the kernels differ in size
+ */
+PPMImage*
+image_convolve_multi(PPMImage* image,
+                     PPMImage kernels[],
+                     int kernel_count,
+                     Combine combine)
+{
+    if (kernel_count < 1) {
+        return NULL;
+    }
+    for (int k = 1; k < kernel_count; k++) {
+        if (kernels[k].height != kernels[0].height ||
+            kernels[k].width != kernels[0].width) {
+            return NULL;
+        }
+    }
+
+    PPMImage copy = image_clone(image);
+
+    for (int i = 0; i < image->height; i++) {
+        for (int j = 0; j < image->width; j++) {
+            copy.data[i][j] = image_convolve_multi_at_point(
+              image, kernels, kernel_count, i, j, combine);
+        }
+    }
+
+    image_copy(&copy, image);
+    image_destroy(&copy);
+
+    return image;
+}
+
 /**
  * @brief square pads the image
  * @param pad_height of the padding
@@ -493,33 +648,91 @@ image_square_pad(const int pad_height,
 }
 
 /**
- * @brief image print  the image
- * @param image being printed
+ * @brief writes the header and samples of an image. binary formats (P4 and
+ * up) write one byte per sample, ascii formats write each pixel's samples
+ * followed by a space and end each row with a newline
  * @param fp where the image is being written
+ * @param magic_number of the output format
+ * @param height of the image
+ * @param width of the image
+ * @param max_intensity of the image
+ * @param channels samples per pixel
+ * @param sample returns channel c of the pixel at i, j
+ * @param image passed through to sample
  */
 void
-image_print(PPMImage* image, FILE* fp)
+image_write(FILE* fp,
+            const char* magic_number,
+            int height,
+            int width,
+            int max_intensity,
+            int channels,
+            int (*sample)(const void* image, int i, int j, int c),
+            const void* image)
 {
-    fprintf(fp,
-            "%s\n%d %d\n%d\n",
-            image->magic_number,
-            image->width,
-            image->height,
-            image->max_intensity);
+    const bool binary = magic_number[1] >= BINARY_MAGIC;
 
-    for (int i = 0; i < image->height; i++) {
-        for (int j = 0; j < image->width; j++) {
-            RGB rgb = image->data[i][j];
-            fprintf(fp,
-                    "%d %d %d ",
-                    (int) rgb.red,
-                    (int) rgb.green,
-                    (int) rgb.blue);
+    fprintf(fp, "%s\n%d %d\n%d\n", magic_number, width, height, max_intensity);
+
+    for (int i = 0; i < height; i++) {
+        for (int j = 0; j < width; j++) {
+            for (int c = 0; c < channels; c++) {
+                const int value = sample(image, i, j, c);
+
+                if (binary) {
+                    fputc(value, fp);
+                } else {
+                    fprintf(fp, "%d ", value);
+                }
+            }
+        }
+        if (!binary) {
+            fprintf(fp, "\n");
         }
-        fprintf(fp, "\n");
     }
 }
 
+/**
+ * @brief sample function for image_write over a ppm image
+ * @param image the PPMImage
+ * @param i row of the pixel
+ * @param j column of the pixel
+ * @param c channel, 0 red, 1 green, 2 blue
+ * @return the channel value
+ */
+static int
+image_sample(const void* image, int i, int j, int c)
+{
+    const RGB rgb = ((const PPMImage*) image)->data[i][j];
+
+    switch (c) {
+        case 0:
+            return rgb.red;
+        case 1:
+            return rgb.green;
+        default:
+            return rgb.blue;
+    }
+}
+
+/**
+ * @brief image print  the image
+ * @param image being printed
+ * @param fp where the image is being written
+ */
+void
+image_print(PPMImage* image, FILE* fp)
+{
+    image_write(fp,
+                image->magic_number,
+                image->height,
+                image->width,
+                image->max_intensity,
+                DEPTH,
+                image_sample,
+                image);
+}
+
 /**
  * @brief creates a gaussian kernel
  * @param height of kernel
@@ -38,6 +38,15 @@ typedef struct {
     RGB** data;
 } PPMImage;
 
+/**
+ * how the results of several kernels are combined into one pixel
+ */
+typedef enum {
+    COMBINE_MAGNITUDE,
+    COMBINE_MAX,
+    COMBINE_SUM
+} Combine;
+
 /**
  * @brief clamp x between two values min and max
  * @param min clamp value
@@ -142,7 +151,7 @@ rgb_add_scalar(int x, RGB* rgb);
  * @reutn the created ppm image
  */
 PPMImage
-image_create(const char magic_number[MAGIC_NUMBER_LENGTH],
+image_create(const char* magic_number,
              const int height,
              const int width,
              const int max_intensity);
@@ -154,6 +163,14 @@ image_create(const char magic_number[MAGIC_NUMBER_LENGTH],
 void
 image_destroy(PPMImage* image);
 
+/**
+ * @brief clone a ppm image
+ * @param image being cloned
+ * @return the cloned image
+ */
+PPMImage
+image_clone(PPMImage* image);
+
 /**
  * @brief fills the ppm image data with rgb values
  * @param image being filled
@@ -173,6 +190,21 @@ image_full(PPMImage* image, RGB* rgb);
 PPMImage*
 image_convolve(PPMImage* image, PPMImage* kernel, bool normalize);
 
+/**
+ * @brief convolves the image with several kernels in a single pass and
+ * combines the results per pixel
+ * @param image being convolved
+ * @param kernels performing the convolution, all the same size
+ * @param kernel_count number of kernels
+ * @param combine how the kernel results are combined
+ * @return the convolved image, or NULL if the kernels differ in size
+ */
+PPMImage*
+image_convolve_multi(PPMImage* image,
+                     PPMImage kernels[],
+                     int kernel_count,
+                     Combine combine);
+
 /**
  * @brief square pads the image
  * @param pad_height of the padding
@@ -187,6 +219,29 @@ image_square_pad(const int pad_height,
                  PPMImage* image,
                  RGB* pad_color);
 
+/**
+ * @brief writes the header and samples of an image. binary formats (P4 and
+ * up) write one byte per sample, ascii formats write each pixel's samples
+ * followed by a space and end each row with a newline
+ * @param fp where the image is being written
+ * @param magic_number of the output format
+ * @param height of the image
+ * @param width of the image
+ * @param max_intensity of the image
+ * @param channels samples per pixel
+ * @param sample returns channel c of the pixel at i, j
+ * @param image passed through to sample
+ */
+void
+image_write(FILE* fp,
+            const char* magic_number,
+            int height,
+            int width,
+            int max_intensity,
+            int channels,
+            int (*sample)(const void* image, int i, int j, int c),
+            const void* image);
+
 /**
  * @brief image print  the image
  * @param image being printed
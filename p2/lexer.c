@@ -42,7 +42,7 @@ make_token(Lexer* lexer, TokenType token_type)
 {
 
     const int length = lexer->current - lexer->start;
-    char* buff = malloc(length + 1);
+    char* buff = arena_alloc(&lexer->arena, length + 1);
 
     strncpy(buff, lexer->buffer, length);
     buff[length] = '\0';
@@ -57,14 +57,14 @@ make_token(Lexer* lexer, TokenType token_type)
 }
 
 /**
- * @brief destroy the token
+ * @brief destroy the token. token text lives in the lexer's arena and is
+ * released when the arena is reset, so this only clears the token
  * @param token being destroyed
  */
 void
 token_destroy(Token* token)
 {
-    free(token->value);
-    token = NULL;
+    token->value = NULL;
 }
 
 /**
@@ -199,10 +199,21 @@ lexer_create(FILE* fp)
                    .column = 0,
                    .line = 0,
 
-                   .source_file = fp};
+                   .source_file = fp,
+                   .arena = arena_create(ARENA_SIZE)};
     return lexer;
 }
 
+/**
+ * @brief destroy a lexer and the text of every token it made
+ * @param lexer being destroyed
+ */
+void
+lexer_destroy(Lexer* lexer)
+{
+    arena_destroy(&lexer->arena);
+}
+
 /**
  * @brief iterates through the token string
  * @param lexer to iterate
@@ -6,10 +6,17 @@
 #ifndef lexer_h
 #define lexer_h
 
+#include "pool.h"
+
 #include <stdio.h>
 
 #define BUFF_SIZE 128
 
+/**
+ * initial size of the token text arena
+ */
+#define ARENA_SIZE 4096
+
 /**
  * enum for the type of token
  */
@@ -48,6 +55,7 @@ typedef struct
     int line;
 
     FILE* source_file;
+    Arena arena;
 } Lexer;
 
 /**
@@ -58,6 +66,13 @@ typedef struct
 Lexer
 lexer_create(FILE* fp);
 
+/**
+ * @brief destroy a lexer and the text of every token it made
+ * @param lexer being destroyed
+ */
+void
+lexer_destroy(Lexer* lexer);
+
 /**
  * @brief iterates through the token string
  * @param lexer to iterate
@@ -70,7 +85,8 @@ lex(Lexer* lexer);
 //token_get_value(Lexer* lexer, Token* token);
 
 /**
- * @brief destroy the token
+ * @brief destroy the token. token text lives in the lexer's arena and is
+ * released when the arena is reset, so this only clears the token
  * @param token being destroyed
  */
 void
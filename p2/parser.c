@@ -73,6 +73,19 @@ unary(Parser* parser)
     }
 }
 
+/**
+ * @brief release the text of every consumed token, keeping only the
+ * lookahead token
+ * @param parser whose lexer arena is reset
+ */
+static void
+parser_reset_tokens(Parser* parser)
+{
+    parser->current.value =
+      arena_reset_keep(&parser->lexer->arena, parser->current.value);
+    parser->previous.value = NULL;
+}
+
 /**
  * @brief parses the header for the ppm image
  * @param parser for creating the header for the ppm image
@@ -103,6 +116,7 @@ parse_header(Parser* parser)
         token_destroy(&height_token);
         token_destroy(&width_token);
         token_destroy(&max_intensity_token);
+        parser_reset_tokens(parser);
 
         return image;
     }
@@ -150,6 +164,7 @@ parse_body(Parser* parser, PPMImage* image)
             RGB rgb = parse_rgb(parser);
             image->data[i][j] = rgb;
         }
+        parser_reset_tokens(parser);
     }
 
     if (parser->current.token_type != TOKEN_EOF) {
@@ -187,5 +202,7 @@ parse_ppm(FILE* fp)
     PPMImage image = parse_header(&parser);
     parse_body(&parser, &image);
 
+    lexer_destroy(&lexer);
+
     return image;
 }
@@ -0,0 +1,269 @@
+/**
+ * @file pool.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * recycles image buffers by size class and bump allocates token text
+ */
+#include "pool.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * number of power of two size classes
+ */
+#define SIZE_CLASSES 48
+/**
+ * smallest size class, 2^MIN_CLASS bytes
+ */
+#define MIN_CLASS 6
+/**
+ * bytes in front of each pooled buffer holding its size class, kept large
+ * enough that the buffer stays aligned for any type
+ */
+#define HEADER_SIZE 16
+/**
+ * arena allocations are rounded up to this alignment
+ */
+#define ARENA_ALIGN 8
+
+/**
+ * free buffers of one size class, linked through their first bytes
+ */
+typedef struct FreeBuffer {
+    struct FreeBuffer* next;
+} FreeBuffer;
+
+/**
+ * free list heads, one per size class
+ */
+static FreeBuffer* FREE_LISTS[SIZE_CLASSES];
+
+/**
+ * guards FREE_LISTS so images can be created and destroyed from any thread
+ */
+static pthread_mutex_t FREE_LISTS_LOCK = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief size class holding size bytes
+ * @param size in bytes
+ * @return the smallest class c with 2^c >= size
+ */
+static int
+size_class(size_t size)
+{
+    int c = MIN_CLASS;
+    while (((size_t) 1 << c) < size) {
+        c++;
+    }
+    return c;
+}
+
+/**
+ * @brief get a buffer of at least size bytes, reusing a freed buffer of the
+ * same size class when there is one. the free lists are locked, so buffers
+ * may be taken and returned from any thread
+ * @param size of the buffer in bytes
+ * @return the buffer
+ */
+void*
+pool_alloc(size_t size)
+{
+    const int c = size_class(size);
+
+    pthread_mutex_lock(&FREE_LISTS_LOCK);
+    FreeBuffer* buffer = FREE_LISTS[c];
+    if (buffer != NULL) {
+        FREE_LISTS[c] = buffer->next;
+    }
+    pthread_mutex_unlock(&FREE_LISTS_LOCK);
+
+    if (buffer != NULL) {
+        return buffer;
+    }
+
+    char* block = malloc(HEADER_SIZE + ((size_t) 1 << c));
+    if (block == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    *(int*) block = c;
+    return block + HEADER_SIZE;
+}
+
+/**
+ * @brief return a buffer from pool_alloc to its size class for reuse
+ * @param ptr buffer being returned, may be NULL
+ */
+void
+pool_free(void* ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+    const int c = *(int*) ((char*) ptr - HEADER_SIZE);
+
+    FreeBuffer* buffer = ptr;
+    pthread_mutex_lock(&FREE_LISTS_LOCK);
+    buffer->next = FREE_LISTS[c];
+    FREE_LISTS[c] = buffer;
+    pthread_mutex_unlock(&FREE_LISTS_LOCK);
+}
+
+/**
+ * @brief free every buffer cached by the pool
+ */
+void
+pool_clear(void)
+{
+    pthread_mutex_lock(&FREE_LISTS_LOCK);
+    for (int c = 0; c < SIZE_CLASSES; c++) {
+        while (FREE_LISTS[c] != NULL) {
+            FreeBuffer* buffer = FREE_LISTS[c];
+            FREE_LISTS[c] = buffer->next;
+            free((char*) buffer - HEADER_SIZE);
+        }
+    }
+    pthread_mutex_unlock(&FREE_LISTS_LOCK);
+}
+
+/**
+ * @brief create an arena
+ * @param capacity of the main block in bytes
+ * @return the created arena
+ */
+Arena
+arena_create(size_t capacity)
+{
+    Arena arena = {.data = malloc(capacity),
+                   .capacity = capacity,
+                   .used = 0,
+                   .overflow_used = 0,
+                   .overflow = NULL};
+    return arena;
+}
+
+/**
+ * @brief free the arena's overflow blocks
+ * @param arena being cleared
+ */
+static void
+arena_free_overflow(Arena* arena)
+{
+    while (arena->overflow != NULL) {
+        ArenaBlock* block = arena->overflow;
+        arena->overflow = block->next;
+        free(block);
+    }
+    arena->overflow_used = 0;
+}
+
+/**
+ * @brief destroy an arena and everything allocated from it
+ * @param arena being destroyed
+ */
+void
+arena_destroy(Arena* arena)
+{
+    arena_free_overflow(arena);
+    free(arena->data);
+    arena->data = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+}
+
+/**
+ * @brief bump allocate from the arena
+ * @param arena to allocate from
+ * @param size in bytes
+ * @return the allocated memory, valid until the next reset
+ */
+void*
+arena_alloc(Arena* arena, size_t size)
+{
+    size = (size + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+
+    if (arena->used + size <= arena->capacity) {
+        void* ptr = arena->data + arena->used;
+        arena->used += size;
+        return ptr;
+    }
+
+    ArenaBlock* block = malloc(sizeof(ArenaBlock) + size);
+    if (block == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    block->next = arena->overflow;
+    arena->overflow = block;
+    arena->overflow_used += size;
+
+    return block->data;
+}
+
+/**
+ * @brief the capacity the main block needs to hold everything allocated
+ * since the last reset, doubling so growth is amortized
+ * @param arena being checked
+ * @return the new capacity, or the current one if nothing overflowed
+ */
+static size_t
+arena_needed_capacity(Arena* arena)
+{
+    size_t capacity = arena->capacity;
+    while (capacity < arena->used + arena->overflow_used) {
+        capacity = capacity == 0 ? ARENA_ALIGN : capacity * 2;
+    }
+    return capacity;
+}
+
+/**
+ * @brief release everything allocated from the arena. if the main block
+ * overflowed it is grown so the same amount of allocation fits next time
+ * @param arena being reset
+ */
+void
+arena_reset(Arena* arena)
+{
+    arena_reset_keep(arena, NULL);
+}
+
+/**
+ * @brief reset the arena but keep one string alive, moving it to the start
+ * of the arena
+ * @param arena being reset
+ * @param str string allocated from the arena, or NULL
+ * @return the new location of str
+ */
+char*
+arena_reset_keep(Arena* arena, char* str)
+{
+    const size_t len = str == NULL ? 0 : strlen(str) + 1;
+    const size_t capacity = arena_needed_capacity(arena);
+
+    if (capacity != arena->capacity) {
+        char* data = malloc(capacity);
+        if (data == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        if (len > 0) {
+            memcpy(data, str, len);
+        }
+        free(arena->data);
+        arena->data = data;
+        arena->capacity = capacity;
+    } else if (len > 0) {
+        memmove(arena->data, str, len);
+    }
+
+    arena_free_overflow(arena);
+    arena->used = 0;
+
+    if (len == 0) {
+        return NULL;
+    }
+    arena->used = (len + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+    return arena->data;
+}
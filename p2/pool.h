@@ -0,0 +1,96 @@
+/**
+ * @file pool.h
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * recycles image buffers by size class and bump allocates token text
+ */
+#ifndef pool_h
+#define pool_h
+
+#include <stddef.h>
+
+/**
+ * overflow block of an arena, used once the arena's main block is full
+ */
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    char data[];
+} ArenaBlock;
+
+/**
+ * bump allocator, everything allocated from it is released together by
+ * arena_reset
+ */
+typedef struct {
+    char* data;
+    size_t capacity;
+    size_t used;
+    size_t overflow_used;
+    ArenaBlock* overflow;
+} Arena;
+
+/**
+ * @brief get a buffer of at least size bytes, reusing a freed buffer of the
+ * same size class when there is one. the free lists are locked, so buffers
+ * may be taken and returned from any thread
+ * @param size of the buffer in bytes
+ * @return the buffer
+ */
+void*
+pool_alloc(size_t size);
+
+/**
+ * @brief return a buffer from pool_alloc to its size class for reuse
+ * @param ptr buffer being returned, may be NULL
+ */
+void
+pool_free(void* ptr);
+
+/**
+ * @brief free every buffer cached by the pool
+ */
+void
+pool_clear(void);
+
+/**
+ * @brief create an arena
+ * @param capacity of the main block in bytes
+ * @return the created arena
+ */
+Arena
+arena_create(size_t capacity);
+
+/**
+ * @brief destroy an arena and everything allocated from it
+ * @param arena being destroyed
+ */
+void
+arena_destroy(Arena* arena);
+
+/**
+ * @brief bump allocate from the arena
+ * @param arena to allocate from
+ * @param size in bytes
+ * @return the allocated memory, valid until the next reset
+ */
+void*
+arena_alloc(Arena* arena, size_t size);
+
+/**
+ * @brief release everything allocated from the arena. if the main block
+ * overflowed it is grown so the same amount of allocation fits next time
+ * @param arena being reset
+ */
+void
+arena_reset(Arena* arena);
+
+/**
+ * @brief reset the arena but keep one string alive, moving it to the start
+ * of the arena
+ * @param arena being reset
+ * @param str string allocated from the arena, or NULL
+ * @return the new location of str
+ */
+char*
+arena_reset_keep(Arena* arena, char* str);
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file ppmcmp.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * compares two ppm images and reports how much they differ
+ */
+#include "compare.h"
+#include "image.h"
+#include "parser.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * exit status when the images differ
+ */
+#define DIFFERENT 1
+/**
+ * exit status for bad arguments or files
+ */
+#define ERROR_ARGS 2
+/**
+ * worker threads used for the metrics
+ */
+#define THREADS 4
+
+/**
+ * @brief prints the usage message and exits
+ */
+static void
+usage()
+{
+    fprintf(stderr, "usage: ppmcmp [-q] image-a image-b\n");
+    exit(ERROR_ARGS);
+}
+
+/**
+ * @brief parses the ppm image in the named file
+ * @param filename of the image
+ * @return the parsed image, or exits if the file can't be opened
+ */
+static PPMImage
+read_image(const char* filename)
+{
+    FILE* fp = fopen(filename, "r");
+
+    if (fp == NULL) {
+        fprintf(stderr, "Can't open file: %s\n", filename);
+        exit(ERROR_ARGS);
+    }
+    PPMImage image = parse_ppm(fp);
+    fclose(fp);
+
+    return image;
+}
+
+/**
+ * @brief compares two ppm images. with -q only the exit status is reported
+ * and comparison stops at the first mismatch, otherwise the max error, psnr
+ * and ssim are printed for images that differ
+ * @param argc number of arguments
+ * @param argv optional -q and the two image files
+ * @return EXIT_SUCCESS if the images match, 1 if they differ, 2 for bad
+ * arguments, 100 or 101 for an invalid image
+ */
+int
+main(int argc, char* argv[])
+{
+    bool quiet = argc == 4 && strcmp(argv[1], "-q") == 0;
+
+    if (argc != 3 && !quiet) {
+        usage();
+    }
+
+    PPMImage a = read_image(argv[argc - 2]);
+    PPMImage b = read_image(argv[argc - 1]);
+
+    int status = EXIT_SUCCESS;
+
+    if (image_equal(&a, &b)) {
+        if (!quiet) {
+            printf("identical\n");
+        }
+    } else if (a.height != b.height || a.width != b.width) {
+        if (!quiet) {
+            printf("size mismatch: %d %d vs %d %d\n",
+                   a.width,
+                   a.height,
+                   b.width,
+                   b.height);
+        }
+        status = DIFFERENT;
+    } else if (a.max_intensity != b.max_intensity) {
+        // The metrics assume both images share one scale.
+        if (!quiet) {
+            printf("max intensity mismatch: %d vs %d\n",
+                   a.max_intensity,
+                   b.max_intensity);
+        }
+        status = DIFFERENT;
+    } else {
+        if (!quiet) {
+            ImageStats stats = image_compare(&a, &b, THREADS);
+
+            printf("max error: %d\n", stats.max_error);
+            printf("psnr: %.4f\n", stats.psnr);
+            printf("ssim: %.6f\n", stats.ssim);
+        }
+        status = DIFFERENT;
+    }
+
+    image_destroy(&a);
+    image_destroy(&b);
+
+    return status;
+}
@@ -0,0 +1,446 @@
+/**
+ * @file resample.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * resizes ppm images with separable resampling filters
+ */
+#include "resample.h"
+
+#include "image.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * pi value
+ */
+#define PI 3.14159265358979323846
+/**
+ * radius of the box filter
+ */
+#define BOX_RADIUS 0.5
+/**
+ * radius of the bilinear filter
+ */
+#define BILINEAR_RADIUS 1.0
+/**
+ * radius of the bicubic filter
+ */
+#define BICUBIC_RADIUS 2.0
+/**
+ * radius of the lanczos filter
+ */
+#define LANCZOS_RADIUS 3.0
+/**
+ * catmull-rom bicubic sharpness
+ */
+#define BICUBIC_A -0.5
+/**
+ * used for dividing by 2
+ */
+#define HALF 0.5
+/**
+ * pixels in a 2x2 block
+ */
+#define BLOCK 4
+
+/**
+ * @brief box filter
+ * @param x distance from the sample center
+ * @return filter weight
+ */
+static double
+box_filter(double x)
+{
+    return (x > -BOX_RADIUS && x <= BOX_RADIUS) ? 1.0 : 0.0;
+}
+
+/**
+ * @brief triangle filter
+ * @param x distance from the sample center
+ * @return filter weight
+ */
+static double
+bilinear_filter(double x)
+{
+    x = fabs(x);
+    return x < BILINEAR_RADIUS ? 1.0 - x : 0.0;
+}
+
+/**
+ * @brief catmull-rom cubic filter
+ * @param x distance from the sample center
+ * @return filter weight
+ */
+static double
+bicubic_filter(double x)
+{
+    const double a = BICUBIC_A;
+    x = fabs(x);
+
+    if (x < 1.0) {
+        return ((a + 2.0) * x - (a + 3.0)) * x * x + 1;
+    } else if (x < BICUBIC_RADIUS) {
+        return (((x - 5) * x + 8) * x - 4) * a;
+    } else {
+        return 0.0;
+    }
+}
+
+/**
+ * @brief normalized sinc
+ * @param x value
+ * @return sin(pi x) / (pi x)
+ */
+static double
+sinc(double x)
+{
+    if (x == 0.0) {
+        return 1.0;
+    }
+    x *= PI;
+    return sin(x) / x;
+}
+
+/**
+ * @brief lanczos filter with three lobes
+ * @param x distance from the sample center
+ * @return filter weight
+ */
+static double
+lanczos3_filter(double x)
+{
+    if (x <= -LANCZOS_RADIUS || x >= LANCZOS_RADIUS) {
+        return 0.0;
+    }
+    return sinc(x) * sinc(x / LANCZOS_RADIUS);
+}
+
+/**
+ * @brief weight function and radius of a filter
+ * @param filter being looked up
+ * @param radius receives the filter radius
+ * @return the weight function
+ */
+static double (*filter_function(Filter filter, double* radius))(double)
+{
+    switch (filter) {
+        case FILTER_BOX:
+            *radius = BOX_RADIUS;
+            return box_filter;
+        case FILTER_BILINEAR:
+            *radius = BILINEAR_RADIUS;
+            return bilinear_filter;
+        case FILTER_BICUBIC:
+            *radius = BICUBIC_RADIUS;
+            return bicubic_filter;
+        case FILTER_LANCZOS3:
+        default:
+            *radius = LANCZOS_RADIUS;
+            return lanczos3_filter;
+    }
+}
+
+/**
+ * @brief builds the weight table mapping in_size samples onto out_size samples
+ * @param in_size number of input samples
+ * @param out_size number of output samples
+ * @param filter used for the weights
+ * @return the weight table
+ */
+WeightTable
+weight_table_create(int in_size, int out_size, Filter filter)
+{
+    double radius = 0;
+    double (*fn)(double) = filter_function(filter, &radius);
+
+    const double scale = (double) in_size / out_size;
+    // When shrinking the filter is stretched so every input sample is used.
+    const double filter_scale = scale > 1.0 ? scale : 1.0;
+    const double support = radius * filter_scale;
+
+    WeightTable table = {.size = out_size,
+                         .max_count = (int) ceil(support) * 2 + 1,
+                         .start = malloc(out_size * sizeof(int)),
+                         .count = malloc(out_size * sizeof(int)),
+                         .weights = NULL};
+    table.weights = calloc(out_size * table.max_count, sizeof(double));
+
+    if (!table.start || !table.count || !table.weights) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < out_size; i++) {
+        const double center = (i + HALF) * scale;
+
+        int min = imax((int) (center - support + HALF), 0);
+        int max = imin((int) (center + support + HALF), in_size);
+        max = imin(max, min + table.max_count);
+
+        double* weights = &table.weights[i * table.max_count];
+        double total = 0;
+
+        for (int x = min; x < max; x++) {
+            weights[x - min] = fn((x - center + HALF) / filter_scale);
+            total += weights[x - min];
+        }
+        if (total != 0.0) {
+            for (int x = min; x < max; x++) {
+                weights[x - min] /= total;
+            }
+        }
+        table.start[i] = min;
+        table.count[i] = max - min;
+    }
+    return table;
+}
+
+/**
+ * @brief destroy a weight table
+ * @param table being destroyed
+ */
+void
+weight_table_destroy(WeightTable* table)
+{
+    free(table->start);
+    free(table->count);
+    free(table->weights);
+    table->start = NULL;
+    table->count = NULL;
+    table->weights = NULL;
+}
+
+/**
+ * one resampling pass over a band of output rows
+ */
+typedef struct {
+    PPMImage* src;
+    PPMImage* dest;
+    const WeightTable* table;
+    bool horizontal;
+    int row_start;
+    int row_end;
+} ResampleJob;
+
+/**
+ * @brief rounds a weighted channel sum to the nearest int
+ * @param x being rounded
+ * @return the rounded value
+ */
+static int
+round_channel(double x)
+{
+    return (int) floor(x + HALF);
+}
+
+/**
+ * @brief runs a resampling pass over the job's row band. the horizontal pass
+ * filters along each row, the vertical pass filters down each column
+ * @param arg the ResampleJob
+ * @return NULL
+ */
+static void*
+resample_rows(void* arg)
+{
+    ResampleJob* job = arg;
+    const WeightTable* table = job->table;
+    const int max_count = table->max_count;
+    const int max_intensity = job->dest->max_intensity;
+
+    // The direction is fixed per job, so each gets its own loop nest.
+    if (job->horizontal) {
+        for (int i = job->row_start; i < job->row_end; i++) {
+            const RGB* in = job->src->data[i];
+            RGB* out = job->dest->data[i];
+
+            for (int j = 0; j < job->dest->width; j++) {
+                const double* weights = &table->weights[j * max_count];
+                const RGB* src = &in[table->start[j]];
+                const int count = table->count[j];
+
+                double red = 0;
+                double green = 0;
+                double blue = 0;
+
+                for (int k = 0; k < count; k++) {
+                    red += weights[k] * src[k].red;
+                    green += weights[k] * src[k].green;
+                    blue += weights[k] * src[k].blue;
+                }
+
+                RGB rgb = {.red = round_channel(red),
+                           .green = round_channel(green),
+                           .blue = round_channel(blue)};
+                out[j] = *rgb_clamp(&rgb, 0, max_intensity);
+            }
+        }
+        return NULL;
+    }
+
+    for (int i = job->row_start; i < job->row_end; i++) {
+        const double* weights = &table->weights[i * max_count];
+        const int start = table->start[i];
+        const int count = table->count[i];
+        RGB* out = job->dest->data[i];
+
+        for (int j = 0; j < job->dest->width; j++) {
+            double red = 0;
+            double green = 0;
+            double blue = 0;
+
+            for (int k = 0; k < count; k++) {
+                const RGB rgb = job->src->data[start + k][j];
+                red += weights[k] * rgb.red;
+                green += weights[k] * rgb.green;
+                blue += weights[k] * rgb.blue;
+            }
+
+            RGB rgb = {.red = round_channel(red),
+                       .green = round_channel(green),
+                       .blue = round_channel(blue)};
+            out[j] = *rgb_clamp(&rgb, 0, max_intensity);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief runs one resampling pass with its rows split across threads
+ * @param src image being read
+ * @param dest image being written
+ * @param table weights for the pass
+ * @param horizontal true for the row pass, false for the column pass
+ * @param threads number of worker threads
+ */
+static void
+resample_pass(PPMImage* src,
+              PPMImage* dest,
+              const WeightTable* table,
+              bool horizontal,
+              int threads)
+{
+    threads = clamp(threads, 1, dest->height);
+
+    pthread_t workers[threads];
+    ResampleJob jobs[threads];
+
+    for (int t = 0; t < threads; t++) {
+        jobs[t] = (ResampleJob){.src = src,
+                                .dest = dest,
+                                .table = table,
+                                .horizontal = horizontal,
+                                .row_start = dest->height * t / threads,
+                                .row_end = dest->height * (t + 1) / threads};
+    }
+
+    // The calling thread takes the first band itself.
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&workers[t], NULL, resample_rows, &jobs[t]) != 0) {
+            resample_rows(&jobs[t]);
+            workers[t] = pthread_self();
+        }
+    }
+    resample_rows(&jobs[0]);
+
+    for (int t = 1; t < threads; t++) {
+        if (!pthread_equal(workers[t], pthread_self())) {
+            pthread_join(workers[t], NULL);
+        }
+    }
+}
+
+/**
+ * @brief resizes an image with a separable filter, horizontal pass then
+ * vertical pass, each pass splitting its rows across threads
+ * @param image being resized
+ * @param height of the resized image
+ * @param width of the resized image
+ * @param filter used for resampling
+ * @param threads number of worker threads per pass
+ * @return the resized image
+ */
+PPMImage
+image_resize(PPMImage* image, int height, int width, Filter filter, int threads)
+{
+    WeightTable columns = weight_table_create(image->width, width, filter);
+    WeightTable rows = weight_table_create(image->height, height, filter);
+
+    PPMImage tmp = image_create(
+      image->magic_number, image->height, width, image->max_intensity);
+    PPMImage out =
+      image_create(image->magic_number, height, width, image->max_intensity);
+
+    resample_pass(image, &tmp, &columns, true, threads);
+    resample_pass(&tmp, &out, &rows, false, threads);
+
+    image_destroy(&tmp);
+    weight_table_destroy(&columns);
+    weight_table_destroy(&rows);
+
+    return out;
+}
+
+/**
+ * @brief halves the image by averaging each 2x2 block, odd edges are clamped
+ * @param image being halved
+ * @return the halved image
+ */
+PPMImage
+image_downscale_2x(PPMImage* image)
+{
+    const int height = (image->height + 1) / 2;
+    const int width = (image->width + 1) / 2;
+
+    PPMImage out =
+      image_create(image->magic_number, height, width, image->max_intensity);
+
+    for (int i = 0; i < height; i++) {
+        const RGB* row0 = image->data[2 * i];
+        const RGB* row1 = image->data[imin(2 * i + 1, image->height - 1)];
+
+        for (int j = 0; j < width; j++) {
+            const int j0 = 2 * j;
+            const int j1 = imin(2 * j + 1, image->width - 1);
+
+            RGB rgb = {
+              .red = (row0[j0].red + row0[j1].red + row1[j0].red +
+                      row1[j1].red + BLOCK / 2) /
+                     BLOCK,
+              .green = (row0[j0].green + row0[j1].green + row1[j0].green +
+                        row1[j1].green + BLOCK / 2) /
+                       BLOCK,
+              .blue = (row0[j0].blue + row0[j1].blue + row1[j0].blue +
+                       row1[j1].blue + BLOCK / 2) /
+                      BLOCK};
+            out.data[i][j] = rgb;
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief builds a mipmap pyramid by repeatedly halving the image until it is
+ * one pixel in either dimension
+ * @param image level zero of the pyramid, copied into levels[0]
+ * @param levels array receiving the levels
+ * @param max_levels capacity of levels
+ * @return the number of levels written
+ */
+int
+image_pyramid(PPMImage* image, PPMImage levels[], int max_levels)
+{
+    if (max_levels < 1) {
+        return 0;
+    }
+    levels[0] = image_clone(image);
+
+    int count = 1;
+    while (count < max_levels && levels[count - 1].height > 1 &&
+           levels[count - 1].width > 1) {
+        levels[count] = image_downscale_2x(&levels[count - 1]);
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file resample.h
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * resizes ppm images with separable resampling filters
+ */
+#ifndef resample_h
+#define resample_h
+
+#include "image.h"
+
+/**
+ * resampling filter used when resizing an image
+ */
+typedef enum {
+    FILTER_BOX,
+    FILTER_BILINEAR,
+    FILTER_BICUBIC,
+    FILTER_LANCZOS3
+} Filter;
+
+/**
+ * precomputed weights for every output index of one resampling pass.
+ * output index i reads count[i] input samples starting at start[i], weighted
+ * by weights[i * max_count + k]
+ */
+typedef struct {
+    int size;
+    int max_count;
+    int* start;
+    int* count;
+    double* weights;
+} WeightTable;
+
+/**
+ * @brief builds the weight table mapping in_size samples onto out_size samples
+ * @param in_size number of input samples
+ * @param out_size number of output samples
+ * @param filter used for the weights
+ * @return the weight table
+ */
+WeightTable
+weight_table_create(int in_size, int out_size, Filter filter);
+
+/**
+ * @brief destroy a weight table
+ * @param table being destroyed
+ */
+void
+weight_table_destroy(WeightTable* table);
+
+/**
+ * @brief resizes an image with a separable filter, horizontal pass then
+ * vertical pass, each pass splitting its rows across threads
+ * @param image being resized
+ * @param height of the resized image
+ * @param width of the resized image
+ * @param filter used for resampling
+ * @param threads number of worker threads per pass
+ * @return the resized image
+ */
+PPMImage
+image_resize(PPMImage* image, int height, int width, Filter filter, int threads);
+
+/**
+ * @brief halves the image by averaging each 2x2 block, odd edges are clamped
+ * @param image being halved
+ * @return the halved image
+ */
+PPMImage
+image_downscale_2x(PPMImage* image);
+
+/**
+ * @brief builds a mipmap pyramid by repeatedly halving the image until it is
+ * one pixel in either dimension
+ * @param image level zero of the pyramid, copied into levels[0]
+ * @param levels array receiving the levels
+ * @param max_levels capacity of levels
+ * @return the number of levels written
+ */
+int
+image_pyramid(PPMImage* image, PPMImage levels[], int max_levels);
+
+#endif
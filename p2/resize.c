@@ -0,0 +1,139 @@
+/**
+ * @file resize.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * resizes an image to a new width and height, or halves it
+ */
+#include "image.h"
+#include "parser.h"
+#include "resample.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * exit status for bad arguments
+ */
+#define ERROR_ARGS 1
+/**
+ * worker threads used for each resampling pass
+ */
+#define THREADS 4
+/**
+ * arguments for a width and height resize
+ */
+#define SIZE_ARGS 3
+/**
+ * arguments for a width and height resize with a filter
+ */
+#define FILTER_ARGS 4
+/**
+ * arguments for printing one level of the mipmap pyramid
+ */
+#define LEVEL_ARGS 3
+/**
+ * most pyramid levels built, enough to halve any int sized image to one pixel
+ */
+#define MAX_LEVELS 32
+
+/**
+ * @brief prints the usage message and exits
+ */
+static void
+usage()
+{
+    fprintf(stderr,
+            "usage: resize (half | level n | width height "
+            "[box|bilinear|bicubic|lanczos])\n");
+    exit(ERROR_ARGS);
+}
+
+/**
+ * @brief looks up a filter by name
+ * @param name of the filter
+ * @return the filter, or exits if the name is unknown
+ */
+static Filter
+parse_filter(const char* name)
+{
+    if (strcmp(name, "box") == 0) {
+        return FILTER_BOX;
+    } else if (strcmp(name, "bilinear") == 0) {
+        return FILTER_BILINEAR;
+    } else if (strcmp(name, "bicubic") == 0) {
+        return FILTER_BICUBIC;
+    } else if (strcmp(name, "lanczos") == 0) {
+        return FILTER_LANCZOS3;
+    }
+    usage();
+    return FILTER_BOX;
+}
+
+/**
+ * @brief resizes the ppm image on stdin and writes it to stdout
+ * @param argc number of arguments
+ * @param argv "half", "level" and a pyramid level, or the new width and
+ * height and an optional filter
+ * @return 1 for bad arguments, 100 if the ppm header is not valid, 101 if
+ * there are invalid pixel values, EXIT_SUCCESS if the image is resized
+ */
+int
+main(int argc, char* argv[])
+{
+    FILE* in_file = stdin;
+    FILE* out_file = stdout;
+
+    if (argc == 2 && strcmp(argv[1], "half") == 0) {
+        PPMImage img = parse_ppm(in_file);
+        PPMImage half = image_downscale_2x(&img);
+
+        image_print(&half, out_file);
+
+        image_destroy(&half);
+        image_destroy(&img);
+        return EXIT_SUCCESS;
+    }
+
+    if (argc == LEVEL_ARGS && strcmp(argv[1], "level") == 0) {
+        int level = atoi(argv[2]);
+        if (level < 0 || level >= MAX_LEVELS) {
+            usage();
+        }
+
+        PPMImage img = parse_ppm(in_file);
+        PPMImage levels[MAX_LEVELS];
+        int count = image_pyramid(&img, levels, level + 1);
+
+        // Past the top of the pyramid the one pixel level is printed.
+        image_print(&levels[count - 1], out_file);
+
+        for (int i = 0; i < count; i++) {
+            image_destroy(&levels[i]);
+        }
+        image_destroy(&img);
+        return EXIT_SUCCESS;
+    }
+
+    if (argc != SIZE_ARGS && argc != FILTER_ARGS) {
+        usage();
+    }
+
+    int width = atoi(argv[1]);
+    int height = atoi(argv[2]);
+    Filter filter = argc == FILTER_ARGS ? parse_filter(argv[SIZE_ARGS])
+                                        : FILTER_BILINEAR;
+
+    if (width < 1 || height < 1) {
+        usage();
+    }
+
+    PPMImage img = parse_ppm(in_file);
+    PPMImage out = image_resize(&img, height, width, filter, THREADS);
+
+    image_print(&out, out_file);
+
+    image_destroy(&out);
+    image_destroy(&img);
+
+    return EXIT_SUCCESS;
+}
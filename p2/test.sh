@@ -107,6 +107,86 @@ else
     FAIL=1
 fi
 
+make edge
+
+# Run tests for just the edge program
+if [ -x edge ] ; then
+    echo "Test 16 : ./edge < image-4.ppm > output.ppm"
+    ./edge < image-4.ppm > output.ppm
+    checkResults 16 0 $?
+
+else
+    echo "**** The edge program didn't compile successfully"
+    FAIL=1
+fi
+
+make resize
+
+# Run tests for just the resize program
+if [ -x resize ] ; then
+    echo "Test 17 : ./resize 50 49 bicubic < image-5.ppm > output.ppm"
+    ./resize 50 49 bicubic < image-5.ppm > output.ppm
+    checkResults 17 0 $?
+
+    echo "Test 18 : ./resize half < image-4.ppm > output.ppm"
+    ./resize half < image-4.ppm > output.ppm
+    checkResults 18 0 $?
+
+    echo "Test 22 : ./resize level 2 < image-5.ppm > output.ppm"
+    ./resize level 2 < image-5.ppm > output.ppm
+    checkResults 22 0 $?
+
+else
+    echo "**** The resize program didn't compile successfully"
+    FAIL=1
+fi
+
+make gray
+
+# Run tests for just the gray program
+if [ -x gray ] ; then
+    echo "Test 19 : ./gray < image-4.ppm > output.ppm"
+    ./gray < image-4.ppm > output.ppm
+    checkResults 19 0 $?
+
+    echo "Test 23 : ./gray ycbcr < image-5.ppm > output.ppm"
+    ./gray ycbcr < image-5.ppm > output.ppm
+    checkResults 23 0 $?
+
+    echo "Test 24 : ./gray rgb < image-5.ppm > output.ppm"
+    ./gray rgb < image-5.ppm > output.ppm
+    checkResults 24 0 $?
+
+    echo "Test 25 : ./gray planes < image-4.ppm > output.ppm"
+    ./gray planes < image-4.ppm > output.ppm
+    checkResults 25 0 $?
+
+    echo "Test 26 : ./gray binary < image-4.ppm > output.ppm"
+    ./gray binary < image-4.ppm > output.ppm
+    checkResults 26 0 $?
+
+else
+    echo "**** The gray program didn't compile successfully"
+    FAIL=1
+fi
+
+make ppmcmp
+
+# Run tests for just the ppmcmp program
+if [ -x ppmcmp ] ; then
+    echo "Test 20 : ./ppmcmp expected-15.ppm expected-14.ppm > output.ppm"
+    ./ppmcmp expected-15.ppm expected-14.ppm > output.ppm
+    checkResults 20 1 $?
+
+    echo "Test 21 : ./ppmcmp image-5.ppm image-5.ppm > output.ppm"
+    ./ppmcmp image-5.ppm image-5.ppm > output.ppm
+    checkResults 21 0 $?
+
+else
+    echo "**** The ppmcmp program didn't compile successfully"
+    FAIL=1
+fi
+
 # Run tests for just the border program
 if [ -x brighten ] && [ -x border ] && [ -x blur ] ; then
     echo "Test 14 : ./brighten < image-5.ppm | ./blur | ./border > output.ppm"
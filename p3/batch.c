@@ -0,0 +1,361 @@
+/**
+ * @file batch.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * applies one mask to many files on a pool of worker threads
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "batch.h"
+
+#include "copy.h"
+#include "lineindex.h"
+#include "mask.h"
+#include "parallel.h"
+#include "text.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/**
+ * bytes read from an input at a time
+ */
+#define BATCH_BLOCK 65536
+
+/**
+ * the files shared by the workers
+ */
+typedef struct {
+    const Mask* mask;
+    SpanList kept;
+    const char* directory;
+    const char* const* files;
+    int count;
+
+    int next;
+    bool ok;
+    pthread_mutex_t lock;
+} Batch;
+
+/**
+ * what one worker keeps between files
+ */
+typedef struct {
+    Batch* batch;
+    char* block;
+    Buffer out;
+} Worker;
+
+/**
+ * @brief check if two open files are the same regular file
+ * @param in the input
+ * @param path of the output
+ * @return true if writing the output would truncate the input
+ */
+static bool
+same_file(FILE* in, const char* path)
+{
+    struct stat in_st;
+    struct stat out_st;
+
+    return fstat(fileno(in), &in_st) == 0 && S_ISREG(in_st.st_mode) &&
+           stat(path, &out_st) == 0 && in_st.st_dev == out_st.st_dev &&
+           in_st.st_ino == out_st.st_ino;
+}
+
+/**
+ * @brief the name a file is written under in the output directory
+ * @param filename of the input
+ * @return the part of the name after the last slash
+ */
+static const char*
+base_name(const char* filename)
+{
+    const char* slash = strrchr(filename, '/');
+    return slash == NULL ? filename : slash + 1;
+}
+
+/**
+ * @brief compare two names for qsort
+ * @param a pointer to the first name
+ * @param b pointer to the second name
+ * @return negative, zero or positive as a sorts before, with or after b
+ */
+static int
+compare_names(const void* a, const void* b)
+{
+    return strcmp(*(const char* const*) a, *(const char* const*) b);
+}
+
+/**
+ * @brief report every output name given to more than one input, since those
+ * outputs would be written over each other
+ * @param directory for the outputs
+ * @param files names of the inputs
+ * @param count number of files
+ * @return true if every output name is different
+ */
+static bool
+unique_names(const char* directory, const char* const files[], int count)
+{
+    const char** names = malloc((count > 0 ? count : 1) * sizeof(char*));
+    if (names == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < count; i++) {
+        names[i] = base_name(files[i]);
+    }
+    qsort(names, count, sizeof(char*), compare_names);
+
+    // Each repeated name is reported once, at its second copy.
+    bool unique = true;
+    for (int i = 1; i < count; i++) {
+        if (strcmp(names[i - 1], names[i]) == 0 &&
+            (i < 2 || strcmp(names[i - 2], names[i]) != 0)) {
+            fprintf(stderr,
+                    "Duplicate output file: %s/%s\n",
+                    directory,
+                    names[i]);
+            unique = false;
+        }
+    }
+    free(names);
+    return unique;
+}
+
+/**
+ * @brief stream the input through the mask with the worker's buffers
+ * @param worker whose buffers are used
+ * @param in the input file pointer
+ * @param out the output file pointer
+ * @return false if the input couldn't be read or the output written
+ */
+static bool
+stream_file(Worker* worker, FILE* in, FILE* out)
+{
+    const Mask* mask = worker->batch->mask;
+    MaskCursor cursor = mask_cursor(mask, 0);
+
+    size_t count;
+    while ((count = fread(worker->block, 1, BATCH_BLOCK, in)) > 0) {
+        mask_feed(mask,
+                  &worker->batch->kept,
+                  &cursor,
+                  worker->block,
+                  count,
+                  &worker->out);
+        fwrite(worker->out.data, 1, worker->out.size, out);
+        worker->out.size = 0;
+    }
+
+    mask_finish(&cursor, &worker->out);
+    fwrite(worker->out.data, 1, worker->out.size, out);
+    worker->out.size = 0;
+
+    // Large writes skip the stream's buffer, so closing the output doesn't
+    // report their errors.
+    return !ferror(in) && !ferror(out);
+}
+
+/**
+ * @brief chop one file into the output directory, the same way a single file
+ * is chopped: copied when only lines are removed, loaded whole when it would
+ * be written over and streamed otherwise
+ * @param worker doing the work
+ * @param filename of the input
+ * @return false if the file couldn't be read or written
+ */
+static bool
+chop_file(Worker* worker, const char* filename)
+{
+    const Mask* mask = worker->batch->mask;
+    const char* directory = worker->batch->directory;
+    const char* name = base_name(filename);
+
+    char path[strlen(directory) + strlen(name) + 2];
+    snprintf(path, sizeof(path), "%s/%s", directory, name);
+
+    FILE* in = fopen(filename, "r");
+    if (in == NULL) {
+        fprintf(stderr, "Can't open file: %s\n", filename);
+        return false;
+    }
+
+    // Patterns are matched against each file, so each gets its own lines.
+    const bool in_place = same_file(in, path);
+    const bool needs_input = mask_needs_input(mask);
+    Mask resolved = *mask;
+    Text text;
+    if (in_place) {
+        text = readFile(in);
+        text_unmap(&text);
+    } else if (needs_input) {
+        text = text_open(in);
+    }
+    if (needs_input) {
+        resolved.lines = mask_resolve_lines(mask, &text);
+    }
+
+    FILE* out = fopen(path, "w");
+    if (out == NULL) {
+        fprintf(stderr, "Can't open file: %s\n", path);
+        if (in_place || needs_input) {
+            text_destroy(&text);
+        }
+        if (needs_input) {
+            free(resolved.lines.spans);
+        }
+        fclose(in);
+        return false;
+    }
+
+    // Only copying seeks, building the index from what it scans.
+    LineIndex index;
+    const bool indexed = !in_place && resolved.lines.size > 0 &&
+                         resolved.cols.size == 0 &&
+                         resolved.fields.size == 0 &&
+                         line_index_open(filename, in, false, &index);
+
+    CopyStatus copied = COPY_SKIPPED;
+    bool ok = true;
+
+    if (in_place) {
+        mask_write(&resolved, &text, out);
+    } else if ((copied = mask_copy(
+                  &resolved, in, out, indexed ? &index : NULL)) !=
+               COPY_SKIPPED) {
+        // Only lines were removed, and the rest was copied as is.
+        ok = copied == COPY_DONE;
+    } else if (needs_input) {
+        ok = mask_write_parallel(&resolved, &text, out, 1, NULL);
+    } else {
+        ok = stream_file(worker, in, out);
+    }
+
+    if (in_place || needs_input) {
+        text_destroy(&text);
+    }
+    if (needs_input) {
+        free(resolved.lines.spans);
+    }
+    if (indexed) {
+        line_index_destroy(&index);
+    }
+    fclose(in);
+    if (fclose(out) != 0 || !ok) {
+        fprintf(stderr, "Can't chop file: %s\n", filename);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief take files from the batch until there are none left
+ * @param arg the Worker
+ * @return NULL
+ */
+static void*
+work(void* arg)
+{
+    Worker* worker = (Worker*) arg;
+    Batch* batch = worker->batch;
+
+    while (true) {
+        pthread_mutex_lock(&batch->lock);
+        const int k = batch->next;
+        batch->next += 1;
+        pthread_mutex_unlock(&batch->lock);
+
+        if (k >= batch->count) {
+            return NULL;
+        }
+
+        if (!chop_file(worker, batch->files[k])) {
+            pthread_mutex_lock(&batch->lock);
+            batch->ok = false;
+            pthread_mutex_unlock(&batch->lock);
+        }
+    }
+}
+
+/**
+ * @brief apply the mask to every file, writing each to the output directory
+ * under its own base name. files are handed out to the worker threads one at
+ * a time, and each worker keeps its buffers from one file to the next. a file
+ * that can't be read or written is reported and the rest are still chopped.
+ * if two inputs share a base name nothing is chopped
+ * @param mask being applied
+ * @param directory for the outputs, created if it doesn't exist
+ * @param files names of the inputs
+ * @param count number of files
+ * @param threads number of worker threads
+ * @return true if every file was chopped
+ */
+bool
+mask_batch(const Mask* mask,
+           const char* directory,
+           const char* const files[],
+           int count,
+           int threads)
+{
+    if (!unique_names(directory, files, count)) {
+        return false;
+    }
+    if (mkdir(directory, 0777) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Can't open file: %s\n", directory);
+        return false;
+    }
+
+    Batch batch = {.mask = mask,
+                   .kept = mask_kept_cols(mask),
+                   .directory = directory,
+                   .files = files,
+                   .count = count,
+                   .next = 0,
+                   .ok = true};
+    pthread_mutex_init(&batch.lock, NULL);
+
+    threads = threads < count ? threads : count;
+    threads = threads > 0 ? threads : 1;
+
+    pthread_t started_threads[threads];
+    Worker workers[threads];
+    int started = 0;
+
+    for (int t = 0; t < threads; t++) {
+        workers[t] = (Worker){.batch = &batch,
+                              .block = malloc(BATCH_BLOCK),
+                              .out = {.data = NULL, .size = 0, .capacity = 0}};
+        if (workers[t].block == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // The calling thread works too, so one fewer thread is started.
+    for (int t = 1; t < threads; t++) {
+        pthread_t* thread = &started_threads[started];
+        if (pthread_create(thread, NULL, work, &workers[t]) == 0) {
+            started += 1;
+        }
+    }
+    work(&workers[0]);
+
+    for (int t = 0; t < started; t++) {
+        pthread_join(started_threads[t], NULL);
+    }
+
+    for (int t = 0; t < threads; t++) {
+        free(workers[t].block);
+        buffer_destroy(&workers[t].out);
+    }
+    pthread_mutex_destroy(&batch.lock);
+    free(batch.kept.spans);
+
+    return batch.ok;
+}
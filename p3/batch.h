@@ -0,0 +1,33 @@
+#ifndef batch_h
+#define batch_h
+
+/**
+ * @file batch.h
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * applies one mask to many files on a pool of worker threads
+ */
+#include "mask.h"
+
+#include <stdbool.h>
+
+/**
+ * @brief apply the mask to every file, writing each to the output directory
+ * under its own base name. files are handed out to the worker threads one at
+ * a time, and each worker keeps its buffers from one file to the next. a file
+ * that can't be read or written is reported and the rest are still chopped.
+ * if two inputs share a base name nothing is chopped
+ * @param mask being applied
+ * @param directory for the outputs, created if it doesn't exist
+ * @param files names of the inputs
+ * @param count number of files
+ * @param threads number of worker threads
+ * @return true if every file was chopped
+ */
+bool
+mask_batch(const Mask* mask,
+           const char* directory,
+           const char* const files[],
+           int count,
+           int threads);
+
+#endif
@@ -3,7 +3,13 @@
  * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
  * edit the data to remove or edit specific lines and colums
  */
-#include "edit.h"
+#define _POSIX_C_SOURCE 200809L
+
+#include "batch.h"
+#include "copy.h"
+#include "lineindex.h"
+#include "mask.h"
+#include "parallel.h"
 #include "parser.h"
 #include "text.h"
 #include "vector.h"
@@ -13,30 +19,45 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-#define THREE 3
-#define FOUR 4
+/**
+ * tmp string for invalid arguments
+ */
+#define INVALID_ARG                                                            \
+    "invalid arguments\nusage: chop command* (infile|-) (outfile|-)\n"
 
 /**
- * tmp file name for command line arguments
+ * full usage, printed for --help and when a pattern is missing
  */
-#define TMP_FILENAME "__tmp.txt"
+#define USAGE                                                                  \
+    "usage: chop [-d delimiter] [-j threads] command* (infile|-) "             \
+    "(outfile|-)\n"                                                            \
+    "       chop [-d delimiter] [-j threads] command* --batch outdir "         \
+    "(infile*|-)\n"                                                            \
+    "commands: line n, lines n m, col n, cols n m, field n, fields n m,\n"     \
+    "          match pattern, nomatch pattern\n"                               \
+    "patterns are literals, anchored only by a leading ^ or a trailing $\n"
 
 /**
- * tmp string for invalid arguments
+ * argument that prints the usage
  */
-#define INVALID_ARG                                                            \
-    "invalid arguments\nusage: chop command* (infile|-) (outfile|-)\n"
+#define HELP_ARG "--help"
 
 /**
- * file string data
+ * argument between the commands and the output directory in batch mode
  */
-extern char FILE_STRING[MAX_ROWS][MAX_COLS];
+#define BATCH_ARG "--batch"
 
 /**
- * row count
+ * options given before the commands: -j N worker threads and -d X field
+ * delimiter
  */
-extern int ROW_COUNT;
+typedef struct {
+    int threads;
+    char delimiter;
+} Options;
 
 /**
  * struct for a argument consisting of (line)s/(col)s, and n (row)s and m
@@ -46,6 +67,7 @@ typedef struct {
     char* name;
     int start;
     int end;
+    char* pattern;
 } Argument;
 
 /**
@@ -85,7 +107,19 @@ bool
 is_list_arg(const char* arg_name)
 {
     return (strcmp(arg_name, "line") == 0 || strcmp(arg_name, "lines") == 0) ||
-           (strcmp(arg_name, "col") == 0 || strcmp(arg_name, "cols") == 0);
+           (strcmp(arg_name, "col") == 0 || strcmp(arg_name, "cols") == 0) ||
+           (strcmp(arg_name, "field") == 0 || strcmp(arg_name, "fields") == 0);
+}
+
+/**
+ * @brief checks to see if the arg name is followed by a pattern
+ * @param arg_name to check
+ * @return true for match and nomatch, false otherwise
+ */
+bool
+is_pattern_arg(const char* arg_name)
+{
+    return strcmp(arg_name, "match") == 0 || strcmp(arg_name, "nomatch") == 0;
 }
 
 /**
@@ -98,12 +132,19 @@ parse_args(Parser* parser)
 {
     Token arg_token = parser_advance(parser);
     char* arg_name = arg_token.value;
-    Argument arg = {"\0", -1, -1};
+    Argument arg = {"\0", -1, -1, NULL};
 
     if (arg_token.token_type == TOKEN_STRING) {
-        if (is_list_arg(arg_name)) {
+        if (is_pattern_arg(arg_name)) {
+            Token pattern = parser_advance(parser);
+            if (pattern.token_type == TOKEN_EOF) {
+                fprintf(stderr, "invalid pattern\n" USAGE);
+                exit(EXIT_FAILURE);
+            }
+            arg.pattern = pattern.value;
+        } else if (is_list_arg(arg_name)) {
             int start = parser_number(parser);
-            int end = arg_name[FOUR] == 's' || arg_name[THREE] == 's'
+            int end = arg_name[strlen(arg_name) - 1] == 's'
                         ? parser_number(parser)
                         : start;
             arg.start = start;
@@ -119,13 +160,13 @@ parse_args(Parser* parser)
 
 /**
  * @brief parse the argument from command line into a vector
- * @param parser to read from
+ * @param source the arguments, one per line
  * @return the created vecttor
  */
 Vector
-parse_args_and_filename(FILE* fp)
+parse_args_and_filename(const char* source)
 {
-    Lexer lexer = lexer_create(fp);
+    Lexer lexer = lexer_create_lines(source);
     Parser parser = parser_create(&lexer);
 
     Vector vec = vector_create(sizeof(Argument));
@@ -158,19 +199,18 @@ open_file(const char* filename, const char* mode)
 }
 
 /**
- * @brief based on the vector arguments edit the file
+ * @brief compile the line, col and field arguments into a mask over the
+ * original input, exiting on an invalid argument. cols count characters and
+ * fields count delimiters, so the two can't be mixed
  * @param vec to read arguments from
+ * @param delimiter between fields
+ * @return the compiled mask
  */
-void
-file_string_edit(Vector* vec)
+Mask
+compile_args(Vector* vec, char delimiter)
 {
-    char* output_filename = ((Argument*) vector_pop(vec))->name;
-    char* input_filename = ((Argument*) vector_pop(vec))->name;
-
-    FILE* input_file = (strcmp(input_filename, "-") == 0)
-                         ? stdin
-                         : open_file(input_filename, "r");
-    readFile(input_file);
+    Mask mask = mask_create();
+    mask.delimiter = delimiter;
 
     for (int i = 0; i < vec->size; i++) {
         Argument* arg = (Argument*) vector_get(vec, i);
@@ -182,25 +222,312 @@ file_string_edit(Vector* vec)
         }
 
         if (strcmp(arg_name, "line") == 0 || strcmp(arg_name, "lines") == 0) {
-            removeLines(arg->start, arg->end);
+            mask_remove_lines(&mask, arg->start, arg->end);
         } else if (strcmp(arg_name, "col") == 0 ||
                    strcmp(arg_name, "cols") == 0) {
-            removeCols(arg->start, arg->end);
+            mask_remove_cols(&mask, arg->start, arg->end);
+        } else if (strcmp(arg_name, "field") == 0 ||
+                   strcmp(arg_name, "fields") == 0) {
+            mask_remove_fields(&mask, arg->start, arg->end);
+        } else if (is_pattern_arg(arg_name) && arg->pattern != NULL) {
+            mask_match_lines(
+              &mask, arg->pattern, strcmp(arg_name, "match") == 0);
         } else {
             fprintf(stderr, INVALID_ARG);
             exit(EXIT_FAILURE);
         }
         free(arg_name);
+        free(arg->pattern);
+    }
+
+    mask_compile(&mask);
+    if (mask.cols.size > 0 && mask.fields.size > 0) {
+        fprintf(stderr, INVALID_ARG);
+        exit(EXIT_FAILURE);
     }
+    return mask;
+}
+
+/**
+ * @brief check if a file is a regular file, which can be mapped
+ * @param fp the file pointer
+ * @param st receives the file's status
+ * @return true if the file is regular
+ */
+static bool
+is_regular(FILE* fp, struct stat* st)
+{
+    return fstat(fileno(fp), st) == 0 && S_ISREG(st->st_mode);
+}
+
+/**
+ * @brief check if the output names the same regular file as the input, which
+ * can't be streamed since opening the output truncates the input
+ * @param input_file the opened input
+ * @param output_filename name of the output, or - for stdout
+ * @return true if they are the same file
+ */
+static bool
+same_file(FILE* input_file, const char* output_filename)
+{
+    struct stat in;
+    struct stat out;
+
+    if (!is_regular(input_file, &in)) {
+        return false;
+    }
+    int status = strcmp(output_filename, "-") == 0
+                   ? fstat(fileno(stdout), &out)
+                   : stat(output_filename, &out);
+
+    return status == 0 && in.st_dev == out.st_dev && in.st_ino == out.st_ino;
+}
+
+/**
+ * @brief based on the vector arguments edit the file. every command is a line
+ * or col range, so the output of a line only depends on the line and its
+ * number, and the input is streamed straight to the output. only editing a
+ * file in place loads it whole first. when only lines are removed from a
+ * regular file, the kept runs are copied without being read. with threads, a
+ * regular input file is mapped and split across worker threads instead. both
+ * save a large input's line index beside it, so later runs find removed
+ * lines without scanning the whole file again
+ * @param vec to read arguments from
+ * @param options from before the commands
+ */
+void
+file_string_edit(Vector* vec, const Options* options)
+{
+    const int threads = options->threads;
+    char* output_filename = ((Argument*) vector_pop(vec))->name;
+    char* input_filename = ((Argument*) vector_pop(vec))->name;
+
+    FILE* input_file = (strcmp(input_filename, "-") == 0)
+                         ? stdin
+                         : open_file(input_filename, "r");
+
+    Mask mask = compile_args(vec, options->delimiter);
+
+    struct stat st;
+    const bool in_place = same_file(input_file, output_filename);
+    const bool needs_input = mask_needs_input(&mask);
+    const bool parallel =
+      !in_place &&
+      (needs_input || (threads > 0 && is_regular(input_file, &st)));
+
+    // Editing in place, or finding the lines patterns match, needs the whole
+    // input before any output.
+    Text text;
+    const bool loaded = in_place || needs_input;
+    if (in_place) {
+        text = readFile(input_file);
+        text_unmap(&text);
+    } else if (needs_input) {
+        text = text_open(input_file);
+    }
+    if (needs_input) {
+        free(mask.lines.spans);
+        mask.lines = mask_resolve_lines(&mask, &text);
+    }
+
+    // Copying only reads up to the last removed line, so it builds the index
+    // from what it scans and saves it once that is most of the file. The
+    // threaded path counts every line without an index, so building one
+    // there up front costs no extra scan. Streaming never seeks.
+    LineIndex index;
+    const bool copies = !in_place && mask.cols.size == 0 &&
+                        mask.fields.size == 0 && is_regular(input_file, &st);
+    const bool indexed =
+      !in_place && mask.lines.size > 0 && (copies || parallel) &&
+      line_index_open(input_filename, input_file, !copies, &index);
 
     FILE* output_file = (strcmp(output_filename, "-") == 0)
                           ? stdout
                           : open_file(output_filename, "w");
 
-    writeFile(output_file);
+    CopyStatus copied = COPY_SKIPPED;
+    bool written = true;
+
+    if (in_place) {
+        mask_write(&mask, &text, output_file);
+    } else if ((copied = mask_copy(&mask,
+                                   input_file,
+                                   output_file,
+                                   indexed ? &index : NULL)) != COPY_SKIPPED) {
+        // Only lines were removed, and the rest was copied as is.
+        written = copied == COPY_DONE;
+    } else if (parallel) {
+        if (!loaded) {
+            text = text_open(input_file);
+        }
+        written = mask_write_parallel(&mask,
+                                      &text,
+                                      output_file,
+                                      threads > 0 ? threads : 1,
+                                      indexed ? &index : NULL);
+        if (!loaded) {
+            text_destroy(&text);
+        }
+    } else {
+        mask_stream(&mask, input_file, output_file);
+        written = fflush(output_file) == 0 && !ferror(output_file);
+    }
+
+    if (loaded) {
+        text_destroy(&text);
+    }
+    if (indexed) {
+        line_index_destroy(&index);
+    }
+    mask_destroy(&mask);
 
     free(input_filename);
     free(output_filename);
+
+    if (!written) {
+        fprintf(stderr, "Can't write output\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief read a manifest of file names, one per line, skipping empty lines
+ * @param fp to read the manifest from
+ * @return vector of the names, each freed by the caller
+ */
+Vector
+read_manifest(FILE* fp)
+{
+    Vector files = vector_create(sizeof(char*));
+    char* line = NULL;
+    size_t line_capacity = 0;
+    ssize_t length;
+
+    while ((length = getline(&line, &line_capacity, fp)) != -1) {
+        if (length > 0 && line[length - 1] == '\n') {
+            line[--length] = '\0';
+        }
+        if (length > 0) {
+            char* name = strdup(line);
+            vector_push(&files, &name);
+        }
+    }
+    free(line);
+    return files;
+}
+
+/**
+ * @brief chop many files with the same commands, which are compiled once.
+ * the first argument is the output directory and the rest are the files, or
+ * - to read their names from stdin. -j N sets the number of worker threads,
+ * one per processor by default
+ * @param vec to read arguments from
+ * @param options from before the commands
+ * @param argc number of arguments after --batch
+ * @param argv the arguments after --batch
+ * @return true if every file was chopped
+ */
+bool
+batch_edit(Vector* vec, const Options* options, int argc, const char* argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr, INVALID_ARG);
+        exit(EXIT_FAILURE);
+    }
+
+    Mask mask = compile_args(vec, options->delimiter);
+    const char* directory = argv[0];
+    const bool manifest = argc == 2 && strcmp(argv[1], "-") == 0;
+
+    int threads = options->threads;
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? online : 1;
+    }
+
+    bool ok;
+    if (manifest) {
+        Vector files = read_manifest(stdin);
+
+        ok = mask_batch(&mask,
+                        directory,
+                        (const char* const*) files.data,
+                        files.size,
+                        threads);
+        for (int i = 0; i < files.size; i++) {
+            free(*(char**) vector_get(&files, i));
+        }
+        vector_destroy(&files);
+    } else {
+        ok = mask_batch(&mask, directory, argv + 1, argc - 1, threads);
+    }
+
+    mask_destroy(&mask);
+    return ok;
+}
+
+/**
+ * @brief join the command line arguments into one string for the lexer, one
+ * argument per line, so each argument is one token even if it has spaces
+ * @param argc number of arguments
+ * @param argv the arguments, argv[0] is skipped
+ * @return the joined string, freed by the caller
+ */
+char*
+join_args(const int argc, const char* argv[])
+{
+    size_t length = 1;
+    for (int i = 1; i < argc; i++) {
+        length += strlen(argv[i]) + 1;
+    }
+
+    char* source = malloc(length);
+    char* end = source;
+
+    for (int i = 1; i < argc; i++) {
+        const size_t arg_length = strlen(argv[i]);
+        memcpy(end, argv[i], arg_length);
+        end += arg_length;
+        *end = '\n';
+        end += 1;
+    }
+    *end = '\0';
+
+    return source;
+}
+
+/**
+ * @brief read the options before the commands: -j N sets the number of worker
+ * threads and -d X the one character field delimiter
+ * @param argc number of arguments
+ * @param argv the arguments
+ * @param options receives the options
+ * @return the number of arguments used by options
+ */
+int
+parse_options(const int argc, const char* argv[], Options* options)
+{
+    int i = 1;
+
+    while (i + 1 < argc) {
+        if (strcmp(argv[i], "-j") == 0) {
+            options->threads = atoi(argv[i + 1]);
+            if (options->threads < 1) {
+                fprintf(stderr, INVALID_ARG);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "-d") == 0) {
+            if (strlen(argv[i + 1]) != 1 || argv[i + 1][0] == '\n') {
+                fprintf(stderr, INVALID_ARG);
+                exit(EXIT_FAILURE);
+            }
+            options->delimiter = argv[i + 1][0];
+        } else {
+            break;
+        }
+        i += 2;
+    }
+    return i - 1;
 }
 
 /**
@@ -212,21 +539,36 @@ file_string_edit(Vector* vec)
 int
 main(const int argc, const char* argv[])
 {
-    // Lexer needs a stream to read from.
-    // This is a hack to do just that.
-    FILE* arg_fp = open_file(TMP_FILENAME, "w+");
-    for (int i = 1; i < argc; i++) {
-        fprintf(arg_fp, "%s\n", argv[i]);
+    if (argc == 2 && strcmp(argv[1], HELP_ARG) == 0) {
+        printf(USAGE);
+        return EXIT_SUCCESS;
     }
-    fseek(arg_fp, 0, SEEK_SET);
 
-    Vector vec = parse_args_and_filename(arg_fp);
+    Options options = {.threads = 0, .delimiter = DEFAULT_DELIMITER};
+    int skip = parse_options(argc, argv, &options);
 
-    file_string_edit(&vec);
+    // The commands end at --batch, if it's there.
+    int batch = skip + 1;
+    while (batch < argc && strcmp(argv[batch], BATCH_ARG) != 0) {
+        batch += 1;
+    }
 
-    vector_destroy(&vec);
+    char* source = join_args(batch - skip, argv + skip);
+    Vector vec = parse_args_and_filename(source);
+    bool ok = true;
 
-    remove(TMP_FILENAME);
+    if (batch < argc) {
+        ok = batch_edit(&vec, &options, argc - batch - 1, argv + batch + 1);
+    } else if (vec.size < 2) {
+        // There have to be input and output file names.
+        fprintf(stderr, INVALID_ARG);
+        exit(EXIT_FAILURE);
+    } else {
+        file_string_edit(&vec, &options);
+    }
+
+    vector_destroy(&vec);
+    free(source);
 
-    return EXIT_SUCCESS;
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
 }
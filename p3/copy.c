@@ -0,0 +1,181 @@
+/**
+ * @file copy.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * copies the runs of untouched lines from input to output inside the kernel
+ */
+#define _GNU_SOURCE
+
+#include "copy.h"
+
+#include "lineindex.h"
+#include "mask.h"
+#include "text.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+/**
+ * how a run is copied, each falling back to the next when the kernel refuses
+ */
+typedef enum { COPY_RANGE, COPY_SENDFILE, COPY_WRITE } CopyMode;
+
+/**
+ * @brief write bytes from memory, retrying short writes
+ * @param fd the output file descriptor
+ * @param data to write
+ * @param length of the data
+ * @return false if the output couldn't be written
+ */
+static bool
+write_all(int fd, const char* data, size_t length)
+{
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= written;
+    }
+    return true;
+}
+
+/**
+ * @brief copy a run of the input to the output, in the kernel if it can be
+ * @param text the mapped input
+ * @param in_fd the input file descriptor
+ * @param out_fd the output file descriptor
+ * @param offset of the run in the input
+ * @param length of the run
+ * @param mode how to copy, lowered when the kernel refuses
+ * @return false if the output couldn't be written
+ */
+static bool
+copy_run(const Text* text,
+         int in_fd,
+         int out_fd,
+         size_t offset,
+         size_t length,
+         CopyMode* mode)
+{
+#ifdef __linux__
+    while (length > 0 && *mode == COPY_RANGE) {
+        loff_t from = offset;
+        ssize_t copied =
+          copy_file_range(in_fd, &from, out_fd, NULL, length, 0);
+        if (copied <= 0) {
+            *mode = COPY_SENDFILE;
+            break;
+        }
+        offset += copied;
+        length -= copied;
+    }
+
+    while (length > 0 && *mode == COPY_SENDFILE) {
+        off_t from = offset;
+        ssize_t copied = sendfile(out_fd, in_fd, &from, length);
+        if (copied <= 0) {
+            *mode = COPY_WRITE;
+            break;
+        }
+        offset += copied;
+        length -= copied;
+    }
+#endif
+
+    return write_all(out_fd, text->buffer + offset, length);
+}
+
+/**
+ * @brief apply a mask that only removes lines by copying the kept runs of
+ * lines straight from the input file to the output, with copy_file_range or
+ * sendfile when the output is a regular file and large writes otherwise.
+ * the input is only read up to the end of the last removed line, and with an
+ * index only from the indexed line before each removed span. an index still
+ * being built is filled in with the lines scanned on the way, and saved if
+ * they cover most of the input
+ * @param mask being applied
+ * @param in the input file pointer
+ * @param out the output file pointer
+ * @param index of the input, or NULL
+ * @return COPY_SKIPPED, having written nothing, if the mask removes cols or
+ * fields or the input isn't a regular file, COPY_FAILED if the output
+ * couldn't be written
+ */
+CopyStatus
+mask_copy(const Mask* mask, FILE* in, FILE* out, LineIndex* index)
+{
+    struct stat in_st;
+    struct stat out_st;
+
+    if (mask->cols.size > 0 || mask->fields.size > 0 ||
+        fstat(fileno(in), &in_st) != 0 ||
+        !S_ISREG(in_st.st_mode)) {
+        return COPY_SKIPPED;
+    }
+
+    fflush(out);
+    const int in_fd = fileno(in);
+    const int out_fd = fileno(out);
+
+    CopyMode mode = fstat(out_fd, &out_st) == 0 && S_ISREG(out_st.st_mode)
+                      ? COPY_RANGE
+                      : COPY_WRITE;
+
+    Text text = text_open(in);
+    size_t pos = 0;
+    size_t kept_end = 0;
+    long line = 0;
+    bool ok = true;
+
+    // Each removed span ends a kept run, only the lines up to the end of the
+    // last removed span are ever scanned, and an index skips most of those.
+    for (int i = 0; ok && i < mask->lines.size && pos < text.size; i++) {
+        const Span span = mask->lines.spans[i];
+
+        if (index != NULL) {
+            line_index_extend(
+              index, &text, span.end == LONG_MAX ? span.start : span.end);
+        }
+        const size_t start =
+          line_index_seek(index, &text, pos, line, span.start);
+
+        ok = copy_run(&text, in_fd, out_fd, pos, start - pos, &mode);
+        kept_end = start > pos ? start : kept_end;
+
+        pos = span.end == LONG_MAX
+                ? text.size
+                : line_index_seek(index, &text, start, span.start, span.end);
+        line = span.end;
+    }
+
+    if (ok && pos < text.size) {
+        ok = copy_run(&text, in_fd, out_fd, pos, text.size - pos, &mode);
+        kept_end = text.size;
+    }
+
+    // A last line without a newline still counts as a line.
+    if (ok && kept_end == text.size && text.size > 0 &&
+        text.buffer[text.size - 1] != '\n') {
+        ok = write_all(out_fd, "\n", 1);
+    }
+
+    if (index != NULL) {
+        line_index_finish(index, &text);
+    }
+    text_destroy(&text);
+    return ok ? COPY_DONE : COPY_FAILED;
+}
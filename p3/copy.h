@@ -0,0 +1,39 @@
+#ifndef copy_h
+#define copy_h
+
+/**
+ * @file copy.h
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * copies the runs of untouched lines from input to output inside the kernel
+ */
+#include "lineindex.h"
+#include "mask.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * what mask_copy did with the input
+ */
+typedef enum { COPY_SKIPPED, COPY_DONE, COPY_FAILED } CopyStatus;
+
+/**
+ * @brief apply a mask that only removes lines by copying the kept runs of
+ * lines straight from the input file to the output, with copy_file_range or
+ * sendfile when the output is a regular file and large writes otherwise.
+ * the input is only read up to the end of the last removed line, and with an
+ * index only from the indexed line before each removed span. an index still
+ * being built is filled in with the lines scanned on the way, and saved if
+ * they cover most of the input
+ * @param mask being applied
+ * @param in the input file pointer
+ * @param out the output file pointer
+ * @param index of the input, or NULL
+ * @return COPY_SKIPPED, having written nothing, if the mask removes cols or
+ * fields or the input isn't a regular file, COPY_FAILED if the output
+ * couldn't be written
+ */
+CopyStatus
+mask_copy(const Mask* mask, FILE* in, FILE* out, LineIndex* index);
+
+#endif
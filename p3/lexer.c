@@ -79,6 +79,38 @@ lexer_is_at_end(Lexer* lexer)
     return lexer->current_char == '\0' || lexer->current_char == EOF;
 }
 
+/**
+ * @brief read the next character from the lexer's source
+ * @param lexer being read
+ * @return the next character, or EOF at the end of the source
+ */
+static int
+lexer_read(Lexer* lexer)
+{
+    if (lexer->source_file != NULL) {
+        return getc(lexer->source_file);
+    } else if (lexer->source[lexer->position] == '\0') {
+        return EOF;
+    } else {
+        return (unsigned char) lexer->source[lexer->position++];
+    }
+}
+
+/**
+ * @brief push a character read by lexer_read back onto the lexer's source
+ * @param lexer being read
+ * @param c the character to push back
+ */
+static void
+lexer_unread(Lexer* lexer, int c)
+{
+    if (lexer->source_file != NULL) {
+        ungetc(c, lexer->source_file);
+    } else if (c != EOF) {
+        lexer->position -= 1;
+    }
+}
+
 /**
  * @brief advance lexer
  * @param lexer being advanced
@@ -90,7 +122,7 @@ lexer_advance(Lexer* lexer)
     char previous = lexer->current_char;
     lexer->buffer[lexer->current] = previous;
 
-    lexer->current_char = getc(lexer->source_file);
+    lexer->current_char = lexer_read(lexer);
     lexer->current += 1;
     return previous;
 }
@@ -107,14 +139,15 @@ lexer_peek(Lexer* lexer, int count)
     if (lexer_is_at_end(lexer)) {
         return '\0';
     } else {
-        char buff[count + 1];
+        // Kept as int so a 0xFF byte can't be mistaken for EOF.
+        int buff[count + 1];
         buff[0] = lexer->current_char;
 
         for (int i = 1; i < count; i++) {
-            buff[i] = getc(lexer->source_file);
+            buff[i] = lexer_read(lexer);
         }
         for (int i = count - 1; i > 0; i--) {
-            ungetc(buff[i], lexer->source_file);
+            lexer_unread(lexer, buff[i]);
         }
 
         return buff[count];
@@ -200,10 +233,86 @@ lexer_create(FILE* fp)
                    .column = 0,
                    .line = 0,
 
-                   .source_file = fp};
+                   .source_file = fp,
+                   .source = NULL,
+                   .position = 0,
+                   .line_tokens = false};
     return lexer;
 }
 
+/**
+ * @brief create a lexer over an in memory string, so no file is needed
+ * @param source null terminated string to lex
+ * @return created lexer
+ */
+Lexer
+lexer_create_string(const char* source)
+{
+    Lexer lexer = lexer_create(NULL);
+    lexer.source = source;
+    return lexer;
+}
+
+/**
+ * @brief create a lexer over an in memory string holding one token per line,
+ * so a token can contain spaces and #. a line of only digits is a number
+ * @param source null terminated string to lex
+ * @return created lexer
+ */
+Lexer
+lexer_create_lines(const char* source)
+{
+    Lexer lexer = lexer_create_string(source);
+    lexer.line_tokens = true;
+    lexer.current_char = lexer_read(&lexer);
+    return lexer;
+}
+
+/**
+ * @brief make a token of the rest of the current line and move to the next
+ * line. the value is read straight from the source, so it isn't limited to
+ * the lexer's buffer
+ * @param lexer being read
+ * @return a number token if the line is only digits, else a string token
+ */
+static Token
+lexer_line(Lexer* lexer)
+{
+    size_t capacity = BUFF_SIZE;
+    size_t length = 0;
+    char* value = malloc(capacity);
+    bool number = true;
+
+    while (!lexer_is_at_end(lexer) && lexer->current_char != '\n') {
+        if (length + 1 == capacity) {
+            capacity *= 2;
+            value = realloc(value, capacity);
+        }
+        if (value == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        value[length] = lexer->current_char;
+        number = number && is_digit(value[length]);
+        length += 1;
+        lexer->current_char = lexer_read(lexer);
+    }
+    value[length] = '\0';
+
+    if (!lexer_is_at_end(lexer)) {
+        lexer->current_char = lexer_read(lexer);
+    }
+    lexer->line += 1;
+
+    Token token = {.token_type =
+                     number && length > 0 ? TOKEN_NUMBER : TOKEN_STRING,
+                   .start = 0,
+                   .length = length,
+                   .line = lexer->line,
+                   .value = value};
+    return token;
+}
+
 /**
  * @brief iterates through the token string
  * @param lexer to iterate
@@ -212,10 +321,12 @@ lexer_create(FILE* fp)
 Token
 lex(Lexer* lexer)
 {
-    if (lexer->source_file == NULL) {
+    if (lexer->source_file == NULL && lexer->source == NULL) {
         return make_token(lexer, TOKEN_ERROR);
-    } else if (feof(lexer->source_file)) {
+    } else if (lexer->source_file != NULL && feof(lexer->source_file)) {
         return make_token(lexer, TOKEN_EOF);
+    } else if (lexer->line_tokens && !lexer_is_at_end(lexer)) {
+        return lexer_line(lexer);
     }
 
     lexer_whitespace(lexer);
@@ -6,6 +6,7 @@
 #ifndef lexer_h
 #define lexer_h
 
+#include <stdbool.h>
 #include <stdio.h>
 
 /**
@@ -44,7 +45,7 @@ typedef struct
  */
 typedef struct
 {
-    char current_char;
+    int current_char;
     char buffer[BUFF_SIZE];
 
     int start;
@@ -54,6 +55,10 @@ typedef struct
     int line;
 
     FILE* source_file;
+
+    const char* source;
+    size_t position;
+    bool line_tokens;
 } Lexer;
 
 /**
@@ -64,6 +69,23 @@ typedef struct
 Lexer
 lexer_create(FILE* fp);
 
+/**
+ * @brief create a lexer over an in memory string, so no file is needed
+ * @param source null terminated string to lex
+ * @return created lexer
+ */
+Lexer
+lexer_create_string(const char* source);
+
+/**
+ * @brief create a lexer over an in memory string holding one token per line,
+ * so a token can contain spaces and #. a line of only digits is a number
+ * @param source null terminated string to lex
+ * @return created lexer
+ */
+Lexer
+lexer_create_lines(const char* source);
+
 /**
  * @brief iterates through the token string
  * @param lexer to iterate
@@ -0,0 +1,397 @@
+/**
+ * @file lineindex.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * sidecar index of where every few thousand lines of a file start
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "lineindex.h"
+
+#include "scan.h"
+#include "text.h"
+#include "vector.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * lines between indexed lines
+ */
+#define INDEX_STEP 4096
+
+/**
+ * smallest file worth indexing, smaller ones are scanned faster than their
+ * index is read
+ */
+#define INDEX_MIN_SIZE 1048576
+
+/**
+ * lines an index being built has room for at first
+ */
+#define INDEX_CAPACITY 64
+
+/**
+ * an index built by the caller's scans is saved once they reach past
+ * 1 / INDEX_SAVE_SHARE of the file, so finishing the scan at most doubles
+ * the work of that run
+ */
+#define INDEX_SAVE_SHARE 2
+
+/**
+ * first bytes of every index file
+ */
+#define INDEX_MAGIC "CHOPIDX1"
+
+#ifdef __APPLE__
+#define MTIME_NSEC(st) ((st).st_mtimespec.tv_nsec)
+#else
+#define MTIME_NSEC(st) ((st).st_mtim.tv_nsec)
+#endif
+
+/**
+ * what an index file starts with, followed by count offsets
+ */
+typedef struct {
+    char magic[8];
+    uint64_t size;
+    int64_t mtime;
+    int64_t mtime_nsec;
+    uint64_t step;
+    uint64_t count;
+} IndexHeader;
+
+/**
+ * @brief read an index file, checking it still describes the input
+ * @param path of the index file
+ * @param st of the input
+ * @param index receives the index
+ * @return true if the index file was read and is up to date
+ */
+static bool
+load_index(const char* path, const struct stat* st, LineIndex* index)
+{
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return false;
+    }
+
+    IndexHeader header;
+    bool valid = fread(&header, sizeof(header), 1, fp) == 1 &&
+                 memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.size == (uint64_t) st->st_size &&
+                 header.mtime == (int64_t) st->st_mtime &&
+                 header.mtime_nsec == (int64_t) MTIME_NSEC(*st) &&
+                 header.step > 0 && header.count > 0 &&
+                 header.count <= header.size;
+
+    uint64_t* offsets = valid ? malloc(header.count * sizeof(uint64_t)) : NULL;
+    valid = offsets != NULL &&
+            fread(offsets, sizeof(uint64_t), header.count, fp) == header.count;
+    fclose(fp);
+
+    // Offsets must climb from zero and stay inside the file to be trusted.
+    for (uint64_t k = 0; valid && k < header.count; k++) {
+        valid = k == 0 ? offsets[k] == 0
+                       : offsets[k] > offsets[k - 1] &&
+                           offsets[k] < header.size;
+    }
+
+    if (!valid) {
+        free(offsets);
+        return false;
+    }
+
+    *index = (LineIndex){.size = header.size,
+                         .mtime = header.mtime,
+                         .mtime_nsec = header.mtime_nsec,
+                         .step = header.step,
+                         .offsets = offsets,
+                         .count = header.count,
+                         .capacity = header.count,
+                         .complete = true,
+                         .path = NULL};
+    return true;
+}
+
+/**
+ * @brief write an index file next to the input. it is written under a
+ * temporary name and renamed, so a reader never sees half of it. failing to
+ * write it only means the next run scans again
+ * @param path of the index file
+ * @param index being written
+ */
+static void
+save_index(const char* path, const LineIndex* index)
+{
+    char tmp[strlen(path) + 32];
+    snprintf(tmp, sizeof(tmp), "%s.%ld", path, (long) getpid());
+
+    FILE* fp = fopen(tmp, "wb");
+    if (fp == NULL) {
+        return;
+    }
+
+    IndexHeader header = {.size = index->size,
+                          .mtime = index->mtime,
+                          .mtime_nsec = index->mtime_nsec,
+                          .step = index->step,
+                          .count = index->count};
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+
+    bool written =
+      fwrite(&header, sizeof(header), 1, fp) == 1 &&
+      fwrite(index->offsets, sizeof(uint64_t), index->count, fp) ==
+        index->count;
+    written = fclose(fp) == 0 && written;
+
+    if (!written || rename(tmp, path) != 0) {
+        remove(tmp);
+    }
+}
+
+/**
+ * @brief scan the input for the start of every step-th line
+ * @param fp the opened input
+ * @param st of the input
+ * @param index receives the index
+ */
+static void
+build_index(FILE* fp, const struct stat* st, LineIndex* index)
+{
+    Text text = text_open(fp);
+    const char* end = text.buffer + text.size;
+    Vector offsets = vector_create(sizeof(uint64_t));
+
+    for (const char* p = text.buffer; offsets.size == 0 || p < end;
+         p = scan_skip(p, end, '\n', INDEX_STEP)) {
+        const uint64_t offset = p - text.buffer;
+        vector_push(&offsets, &offset);
+    }
+    vector_shrink(&offsets);
+
+    // The index keeps the vector's storage.
+    *index = (LineIndex){.size = text.size,
+                         .mtime = st->st_mtime,
+                         .mtime_nsec = MTIME_NSEC(*st),
+                         .step = INDEX_STEP,
+                         .offsets = (uint64_t*) offsets.data,
+                         .count = offsets.size,
+                         .capacity = offsets.size,
+                         .complete = true,
+                         .path = NULL};
+    text_destroy(&text);
+}
+
+/**
+ * @brief start an empty index, holding only line 0, for the caller to build
+ * @param path of the sidecar it is saved to
+ * @param st of the input
+ * @param index receives the index
+ */
+static void
+start_index(const char* path, const struct stat* st, LineIndex* index)
+{
+    uint64_t* offsets = malloc(INDEX_CAPACITY * sizeof(uint64_t));
+    char* copy = malloc(strlen(path) + 1);
+
+    if (offsets == NULL || copy == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    offsets[0] = 0;
+    strcpy(copy, path);
+
+    *index = (LineIndex){.size = st->st_size,
+                         .mtime = st->st_mtime,
+                         .mtime_nsec = MTIME_NSEC(*st),
+                         .step = INDEX_STEP,
+                         .offsets = offsets,
+                         .count = 1,
+                         .capacity = INDEX_CAPACITY,
+                         .complete = false,
+                         .path = copy};
+}
+
+/**
+ * @brief load the index of a file from its sidecar. if there is no sidecar,
+ * or it is out of date, a large enough file is either scanned whole and the
+ * sidecar written for next time, or the index starts empty for the caller
+ * to fill in with line_index_extend as it scans and save with
+ * line_index_finish
+ * @param filename of the input, - for stdin which is never indexed
+ * @param fp the opened input
+ * @param build true to scan the whole file now, for callers that would scan
+ * it all anyway, false to start the index empty
+ * @param index receives the index
+ * @return true if the index was loaded, built or started
+ */
+bool
+line_index_open(const char* filename,
+                FILE* fp,
+                bool build,
+                LineIndex* index)
+{
+    struct stat st;
+
+    if (strcmp(filename, "-") == 0 || fstat(fileno(fp), &st) != 0 ||
+        !S_ISREG(st.st_mode) || st.st_size < INDEX_MIN_SIZE) {
+        return false;
+    }
+
+    char path[strlen(filename) + sizeof(INDEX_SUFFIX)];
+    strcpy(path, filename);
+    strcat(path, INDEX_SUFFIX);
+
+    if (load_index(path, &st, index)) {
+        return true;
+    } else if (!build) {
+        start_index(path, &st, index);
+        return true;
+    }
+
+    build_index(fp, &st, index);
+    save_index(path, index);
+    return true;
+}
+
+/**
+ * @brief add the lines up to a target to an index the caller is building,
+ * scanning on from the last line indexed. a complete index is left as is
+ * @param index being built
+ * @param text the mapped input
+ * @param target line to index up to, LONG_MAX for the whole file
+ */
+void
+line_index_extend(LineIndex* index, const Text* text, long target)
+{
+    const char* end = text->buffer + text->size;
+
+    while (!index->complete &&
+           index->count * index->step <= (uint64_t) target) {
+        const char* next = scan_skip(text->buffer +
+                                       index->offsets[index->count - 1],
+                                     end,
+                                     '\n',
+                                     index->step);
+        if (next >= end) {
+            index->complete = true;
+            break;
+        }
+
+        if (index->count == index->capacity) {
+            index->capacity *= 2;
+            index->offsets =
+              realloc(index->offsets, index->capacity * sizeof(uint64_t));
+            if (index->offsets == NULL) {
+                fprintf(stderr, "Out of memory\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        index->offsets[index->count++] = next - text->buffer;
+    }
+}
+
+/**
+ * @brief save the sidecar of an index the caller built, once its scans have
+ * covered most of the file. the rest of the file is scanned first, so the
+ * next run has every line indexed. an index that was loaded or already
+ * saved is left as is
+ * @param index being built
+ * @param text the mapped input
+ */
+void
+line_index_finish(LineIndex* index, const Text* text)
+{
+    if (index->path == NULL ||
+        (!index->complete && index->offsets[index->count - 1] <
+                               index->size / INDEX_SAVE_SHARE)) {
+        return;
+    }
+
+    line_index_extend(index, text, LONG_MAX);
+    save_index(index->path, index);
+    free(index->path);
+    index->path = NULL;
+}
+
+/**
+ * @brief find where a line starts, jumping to the nearest indexed line at or
+ * after the current one and scanning from there
+ * @param index of the text, or NULL to scan from the current line
+ * @param text the mapped input
+ * @param pos start of the current line
+ * @param line the current line, zero based
+ * @param target the line to find, at or after line
+ * @return start of the target line, or the end of the text
+ */
+size_t
+line_index_seek(const LineIndex* index,
+                const Text* text,
+                size_t pos,
+                long line,
+                long target)
+{
+    if (index != NULL && target - line > (long) index->step) {
+        uint64_t k = (uint64_t) target / index->step;
+        k = k < index->count ? k : index->count - 1;
+
+        if ((long) (k * index->step) > line &&
+            index->offsets[k] <= text->size) {
+            pos = index->offsets[k];
+            line = k * index->step;
+        }
+    }
+
+    const char* end = text->buffer + text->size;
+    return scan_skip(text->buffer + pos, end, '\n', target - line) -
+           text->buffer;
+}
+
+/**
+ * @brief find the number of the line starting at pos, scanning from the
+ * nearest indexed line before it
+ * @param index of the text
+ * @param text the mapped input
+ * @param pos start of a line
+ * @return the zero based line number
+ */
+long
+line_index_line_at(const LineIndex* index, const Text* text, size_t pos)
+{
+    uint64_t low = 0;
+    uint64_t high = index->count;
+
+    // Find the last indexed line starting at or before pos.
+    while (high - low > 1) {
+        const uint64_t mid = low + (high - low) / 2;
+        if (index->offsets[mid] <= pos) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    const size_t from = index->offsets[low] < pos ? index->offsets[low] : pos;
+    return low * index->step +
+           scan_count(text->buffer + from, text->buffer + pos, '\n');
+}
+
+/**
+ * @brief destroy the index
+ * @param index being destroyed
+ */
+void
+line_index_destroy(LineIndex* index)
+{
+    free(index->offsets);
+    free(index->path);
+    index->offsets = NULL;
+    index->path = NULL;
+    index->count = 0;
+}
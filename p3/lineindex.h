@@ -0,0 +1,115 @@
+#ifndef lineindex_h
+#define lineindex_h
+
+/**
+ * @file lineindex.h
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * sidecar index of where every few thousand lines of a file start
+ */
+#include "text.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * suffix added to the input file name for its index
+ */
+#define INDEX_SUFFIX ".chopidx"
+
+/**
+ * offsets of the lines 0, step, 2 * step, ... of a file, valid while the file
+ * keeps the size and modification time it had when indexed. an index the
+ * caller builds by scanning holds the lines scanned so far, is complete once
+ * the scan reaches the end of the file, and keeps the path of its sidecar
+ * until it is saved
+ */
+typedef struct {
+    uint64_t size;
+    int64_t mtime;
+    int64_t mtime_nsec;
+    uint64_t step;
+
+    uint64_t* offsets;
+    uint64_t count;
+    uint64_t capacity;
+    bool complete;
+    char* path;
+} LineIndex;
+
+/**
+ * @brief load the index of a file from its sidecar. if there is no sidecar,
+ * or it is out of date, a large enough file is either scanned whole and the
+ * sidecar written for next time, or the index starts empty for the caller
+ * to fill in with line_index_extend as it scans and save with
+ * line_index_finish
+ * @param filename of the input, - for stdin which is never indexed
+ * @param fp the opened input
+ * @param build true to scan the whole file now, for callers that would scan
+ * it all anyway, false to start the index empty
+ * @param index receives the index
+ * @return true if the index was loaded, built or started
+ */
+bool
+line_index_open(const char* filename,
+                FILE* fp,
+                bool build,
+                LineIndex* index);
+
+/**
+ * @brief add the lines up to a target to an index the caller is building,
+ * scanning on from the last line indexed. a complete index is left as is
+ * @param index being built
+ * @param text the mapped input
+ * @param target line to index up to, LONG_MAX for the whole file
+ */
+void
+line_index_extend(LineIndex* index, const Text* text, long target);
+
+/**
+ * @brief save the sidecar of an index the caller built, once its scans have
+ * covered most of the file. the rest of the file is scanned first, so the
+ * next run has every line indexed. an index that was loaded or already
+ * saved is left as is
+ * @param index being built
+ * @param text the mapped input
+ */
+void
+line_index_finish(LineIndex* index, const Text* text);
+
+/**
+ * @brief find where a line starts, jumping to the nearest indexed line at or
+ * after the current one and scanning from there
+ * @param index of the text, or NULL to scan from the current line
+ * @param text the mapped input
+ * @param pos start of the current line
+ * @param line the current line, zero based
+ * @param target the line to find, at or after line
+ * @return start of the target line, or the end of the text
+ */
+size_t
+line_index_seek(const LineIndex* index,
+                const Text* text,
+                size_t pos,
+                long line,
+                long target);
+
+/**
+ * @brief find the number of the line starting at pos, scanning from the
+ * nearest indexed line before it
+ * @param index of the text
+ * @param text the mapped input
+ * @param pos start of a line
+ * @return the zero based line number
+ */
+long
+line_index_line_at(const LineIndex* index, const Text* text, size_t pos);
+
+/**
+ * @brief destroy the index
+ * @param index being destroyed
+ */
+void
+line_index_destroy(LineIndex* index);
+
+#endif
@@ -0,0 +1,653 @@
+/**
+ * @file mask.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * compiles chop's line, col and field commands into masks over the original
+ * input
+ */
+#include "mask.h"
+
+#include "pattern.h"
+#include "scan.h"
+#include "spanset.h"
+#include "text.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * initial capacity of the line commands waiting for the input
+ */
+#define COMMAND_CAPACITY 8
+
+/**
+ * size of the fixed buffer used when streaming
+ */
+#define STREAM_BLOCK 65536
+
+/**
+ * initial capacity of an output buffer
+ */
+#define BUFFER_SIZE 4096
+
+/**
+ * @brief create an empty mask that keeps everything, splitting fields at
+ * DEFAULT_DELIMITER
+ * @return the created mask
+ */
+Mask
+mask_create(void)
+{
+    Mask mask = {.lines = span_list_create(),
+                 .cols = span_list_create(),
+                 .fields = span_list_create(),
+                 .delimiter = DEFAULT_DELIMITER,
+                 .removed_lines = span_set_create(),
+                 .removed_cols = span_set_create(),
+                 .removed_fields = span_set_create(),
+                 .commands = NULL,
+                 .command_count = 0,
+                 .command_capacity = 0};
+    return mask;
+}
+
+/**
+ * @brief destroy a mask
+ * @param mask being destroyed
+ */
+void
+mask_destroy(Mask* mask)
+{
+    free(mask->lines.spans);
+    free(mask->cols.spans);
+    free(mask->fields.spans);
+    mask->lines.spans = NULL;
+    mask->cols.spans = NULL;
+    mask->fields.spans = NULL;
+    span_set_destroy(&mask->removed_lines);
+    span_set_destroy(&mask->removed_cols);
+    span_set_destroy(&mask->removed_fields);
+
+    for (int i = 0; i < mask->command_count; i++) {
+        if (mask->commands[i].filter) {
+            pattern_destroy(&mask->commands[i].pattern);
+            free(mask->commands[i].cols.spans);
+            free(mask->commands[i].fields.spans);
+        }
+    }
+    free(mask->commands);
+    mask->commands = NULL;
+    mask->command_count = 0;
+}
+
+/**
+ * @brief add a line command that waits for the input
+ * @param mask to add to
+ * @param command being added
+ */
+static void
+push_command(Mask* mask, LineCommand command)
+{
+    if (mask->command_count == mask->command_capacity) {
+        mask->command_capacity = mask->command_capacity == 0
+                                   ? COMMAND_CAPACITY
+                                   : mask->command_capacity * 2;
+        LineCommand* commands = realloc(
+          mask->commands, mask->command_capacity * sizeof(LineCommand));
+        if (commands == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        mask->commands = commands;
+    }
+    mask->commands[mask->command_count] = command;
+    mask->command_count += 1;
+}
+
+/**
+ * @brief remove lines start to end (one based, inclusive), numbered as they
+ * are after every earlier removal, the same as running the commands in order
+ * @param mask to add to
+ * @param start first line to remove
+ * @param end last line to remove
+ */
+void
+mask_remove_lines(Mask* mask, long start, long end)
+{
+    start = start < 1 ? 1 : start;
+    end = end < 1 ? 1 : end;
+
+    // After a pattern, the lines are numbered by what it matched.
+    if (mask->command_count > 0) {
+        LineCommand command = {.start = start, .end = end, .filter = false};
+        push_command(mask, command);
+    } else {
+        span_set_remove_shifted(&mask->removed_lines, start - 1, end);
+    }
+}
+
+/**
+ * @brief remove cols start to end (one based, inclusive), numbered as they
+ * are after every earlier removal, the same as running the commands in order
+ * @param mask to add to
+ * @param start first col to remove
+ * @param end last col to remove
+ */
+void
+mask_remove_cols(Mask* mask, long start, long end)
+{
+    start = start < 1 ? 1 : start;
+    end = end < 1 ? 1 : end;
+    span_set_remove_shifted(&mask->removed_cols, start - 1, end);
+}
+
+/**
+ * @brief remove fields start to end (one based, inclusive), numbered as they
+ * are after every earlier removal, the same as running the commands in order
+ * @param mask to add to
+ * @param start first field to remove
+ * @param end last field to remove
+ */
+void
+mask_remove_fields(Mask* mask, long start, long end)
+{
+    start = start < 1 ? 1 : start;
+    end = end < 1 ? 1 : end;
+    span_set_remove_shifted(&mask->removed_fields, start - 1, end);
+}
+
+/**
+ * @brief keep (match) or remove (nomatch) the lines the pattern is found in,
+ * out of the lines still kept. patterns are matched against the lines as
+ * they are after every earlier col or field removal, the same as running the
+ * commands in order
+ * @param mask to add to
+ * @param source of the pattern
+ * @param keep true to keep the matching lines, false to remove them
+ */
+void
+mask_match_lines(Mask* mask, const char* source, bool keep)
+{
+    LineCommand command = {.start = 0,
+                           .end = 0,
+                           .filter = true,
+                           .keep = keep,
+                           .pattern = pattern_create(source),
+                           .cols = span_set_list(&mask->removed_cols),
+                           .fields = span_set_list(&mask->removed_fields)};
+    push_command(mask, command);
+}
+
+/**
+ * @brief check if the removed lines depend on the input
+ * @param mask being checked
+ * @return true if mask_resolve_lines has to be given the input
+ */
+bool
+mask_needs_input(const Mask* mask)
+{
+    return mask->command_count > 0;
+}
+
+/**
+ * @brief the input as a pattern sees it, with the cols or fields removed
+ * before the pattern taken out of every line
+ * @param mask being applied
+ * @param command the pattern
+ * @param text the input
+ * @return the edited lines, destroyed by the caller with buffer_destroy
+ */
+static Buffer
+pattern_input(const Mask* mask, const LineCommand* command, const Text* text)
+{
+    // The command's spans are borrowed, so the mask isn't destroyed.
+    const Mask edits = {.lines = {.spans = NULL, .size = 0, .capacity = 0},
+                        .cols = command->cols,
+                        .fields = command->fields,
+                        .delimiter = mask->delimiter};
+    SpanList kept = mask_kept_cols(&edits);
+    Buffer out = {.data = NULL, .size = 0, .capacity = 0};
+    MaskCursor cursor = mask_cursor(&edits, 0);
+
+    mask_feed(&edits, &kept, &cursor, text->buffer, text->size, &out);
+    mask_finish(&cursor, &out);
+
+    free(kept.spans);
+    return out;
+}
+
+/**
+ * @brief run the line commands that wait for the input
+ * @param mask being applied
+ * @param text the input
+ * @return every removed line, destroyed by the caller with free(list.spans)
+ */
+SpanList
+mask_resolve_lines(const Mask* mask, const Text* text)
+{
+    SpanSet removed = span_set_copy(&mask->removed_lines);
+
+    for (int i = 0; i < mask->command_count; i++) {
+        const LineCommand* command = &mask->commands[i];
+
+        if (!command->filter) {
+            span_set_remove_shifted(&removed, command->start - 1, command->end);
+            continue;
+        }
+
+        Buffer edited = {.data = NULL, .size = 0, .capacity = 0};
+        const char* data = text->buffer;
+        size_t size = text->size;
+        if (command->cols.size > 0 || command->fields.size > 0) {
+            edited = pattern_input(mask, command, text);
+            data = edited.data;
+            size = edited.size;
+        }
+
+        long line_count;
+        SpanList found =
+          pattern_lines(&command->pattern, data, size, &line_count);
+        buffer_destroy(&edited);
+
+        // Lines already removed can be removed again, so only the found
+        // lines matter, not which of them are still kept.
+        if (command->keep) {
+            long cursor = 0;
+            for (int k = 0; k < found.size; k++) {
+                span_set_add(&removed, cursor, found.spans[k].start);
+                cursor = found.spans[k].end;
+            }
+            span_set_add(&removed, cursor, line_count);
+        } else {
+            for (int k = 0; k < found.size; k++) {
+                const Span span = found.spans[k];
+                span_set_add(&removed, span.start, span.end);
+            }
+        }
+        free(found.spans);
+    }
+
+    SpanList lines = span_set_list(&removed);
+    span_set_destroy(&removed);
+    return lines;
+}
+
+/**
+ * @brief list the removed spans in order, ready for the mask to be applied.
+ * call once after the last removal
+ * @param mask being compiled
+ */
+void
+mask_compile(Mask* mask)
+{
+    free(mask->lines.spans);
+    free(mask->cols.spans);
+    free(mask->fields.spans);
+    mask->lines = span_set_list(&mask->removed_lines);
+    mask->cols = span_set_list(&mask->removed_cols);
+    mask->fields = span_set_list(&mask->removed_fields);
+}
+
+/**
+ * @brief the cols the mask keeps, the last span running to LONG_MAX
+ * @param mask being applied
+ * @return the kept spans, destroyed by the caller with free(list.spans)
+ */
+SpanList
+mask_kept_cols(const Mask* mask)
+{
+    SpanList kept = span_list_create();
+    long cursor = 0;
+
+    for (int i = 0; i < mask->cols.size; i++) {
+        span_list_push(&kept, cursor, mask->cols.spans[i].start);
+        cursor = mask->cols.spans[i].end;
+    }
+    span_list_push(&kept, cursor, LONG_MAX);
+
+    return kept;
+}
+
+/**
+ * @brief write the text with the mask applied in a single pass, copying the
+ * kept col spans or fields of each kept line
+ * @param mask being applied
+ * @param text being written
+ * @param fp the file pointer
+ */
+void
+mask_write(const Mask* mask, const Text* text, FILE* fp)
+{
+    SpanList kept = mask_kept_cols(mask);
+    Buffer buffer = {.data = NULL, .size = 0, .capacity = 0};
+
+    for (long i = 0; i < text->line_count; i++) {
+        MaskCursor cursor = mask_cursor(mask, i);
+        if (!cursor.keep) {
+            continue;
+        }
+        const Line line = text->lines[i];
+
+        mask_feed(mask,
+                  &kept,
+                  &cursor,
+                  text->buffer + line.offset,
+                  line.length,
+                  &buffer);
+        buffer_append(&buffer, "\n", 1);
+
+        if (buffer.size >= STREAM_BLOCK) {
+            fwrite(buffer.data, 1, buffer.size, fp);
+            buffer.size = 0;
+        }
+    }
+    fwrite(buffer.data, 1, buffer.size, fp);
+
+    buffer_destroy(&buffer);
+    free(kept.spans);
+}
+
+/**
+ * @brief append bytes to a buffer, growing it as needed
+ * @param buffer being appended to
+ * @param data to append
+ * @param length of the data
+ */
+void
+buffer_append(Buffer* buffer, const char* data, size_t length)
+{
+    if (buffer->size + length > buffer->capacity) {
+        size_t capacity = buffer->capacity > 0 ? buffer->capacity : BUFFER_SIZE;
+        while (buffer->size + length > capacity) {
+            capacity *= 2;
+        }
+        char* grown = realloc(buffer->data, capacity);
+        if (grown == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->size, data, length);
+    buffer->size += length;
+}
+
+/**
+ * @brief release a buffer
+ * @param buffer being destroyed
+ */
+void
+buffer_destroy(Buffer* buffer)
+{
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+}
+
+/**
+ * @brief start a cursor at the beginning of a line
+ * @param mask being applied
+ * @param line zero based number of the line the cursor starts on
+ * @return the cursor
+ */
+MaskCursor
+mask_cursor(const Mask* mask, long line)
+{
+    // First removed span that ends after the line.
+    int lo = 0;
+    int hi = mask->lines.size;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (mask->lines.spans[mid].end <= line) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    MaskCursor cursor = {.line = line,
+                         .col = 0,
+                         .span = lo,
+                         .open = false,
+                         .keep = lo == mask->lines.size ||
+                                 mask->lines.spans[lo].start > line,
+                         .field = 0,
+                         .field_span = 0,
+                         .field_kept = mask->fields.size == 0 ||
+                                       mask->fields.spans[0].start > 0,
+                         .emitted = false};
+    return cursor;
+}
+
+/**
+ * @brief move the cursor to the start of the next line
+ * @param mask being applied
+ * @param cursor position in the input
+ */
+static void
+next_line(const Mask* mask, MaskCursor* cursor)
+{
+    cursor->line += 1;
+    cursor->col = 0;
+    cursor->open = false;
+
+    // Removed line spans are sorted, so the cursor only moves forward.
+    while (cursor->span < mask->lines.size &&
+           mask->lines.spans[cursor->span].end <= cursor->line) {
+        cursor->span += 1;
+    }
+    cursor->keep = cursor->span == mask->lines.size ||
+                   mask->lines.spans[cursor->span].start > cursor->line;
+
+    cursor->field = 0;
+    cursor->field_span = 0;
+    cursor->field_kept =
+      mask->fields.size == 0 || mask->fields.spans[0].start > 0;
+    cursor->emitted = false;
+}
+
+/**
+ * @brief move the cursor to the next field of the line, writing the
+ * delimiter if the field is kept and follows a written field
+ * @param mask being applied
+ * @param cursor position in the input
+ * @param out buffer the kept text is appended to
+ */
+static void
+next_field(const Mask* mask, MaskCursor* cursor, Buffer* out)
+{
+    cursor->field += 1;
+
+    while (cursor->field_span < mask->fields.size &&
+           mask->fields.spans[cursor->field_span].end <= cursor->field) {
+        cursor->field_span += 1;
+    }
+    cursor->field_kept =
+      cursor->field_span == mask->fields.size ||
+      mask->fields.spans[cursor->field_span].start > cursor->field;
+
+    if (cursor->keep && cursor->field_kept) {
+        if (cursor->emitted) {
+            buffer_append(out, &mask->delimiter, 1);
+        }
+        cursor->emitted = true;
+    }
+}
+
+/**
+ * @brief apply a field mask to the next piece of the input, finding the
+ * newlines and delimiters with one scan
+ * @param mask being applied
+ * @param cursor position in the input
+ * @param data of the piece
+ * @param end of the piece
+ * @param out buffer the kept text is appended to
+ */
+static void
+feed_fields(const Mask* mask,
+            MaskCursor* cursor,
+            const char* data,
+            const char* end,
+            Buffer* out)
+{
+    while (data < end) {
+        const char* stop = scan_find(data, end, '\n', mask->delimiter);
+
+        if (!cursor->open && cursor->keep && cursor->field_kept) {
+            cursor->emitted = true;
+        }
+        if (cursor->keep && cursor->field_kept) {
+            buffer_append(out, data, stop - data);
+        }
+        cursor->open = true;
+
+        if (stop == end) {
+            break;
+        }
+        if (*stop == '\n') {
+            if (cursor->keep) {
+                buffer_append(out, "\n", 1);
+            }
+            next_line(mask, cursor);
+        } else {
+            next_field(mask, cursor, out);
+        }
+        data = stop + 1;
+    }
+}
+
+/**
+ * @brief append the part of a line from col to col + length that falls in the
+ * kept col spans
+ * @param kept col spans
+ * @param data of the line piece
+ * @param col of the first byte of the piece, zero based
+ * @param length of the piece
+ * @param out buffer being appended to
+ */
+static void
+append_kept_cols(const SpanList* kept,
+                 const char* data,
+                 long col,
+                 long length,
+                 Buffer* out)
+{
+    const long last = col + length;
+
+    for (int k = 0; k < kept->size; k++) {
+        if (kept->spans[k].start >= last) {
+            break;
+        }
+        const long start =
+          kept->spans[k].start > col ? kept->spans[k].start : col;
+        const long end = kept->spans[k].end < last ? kept->spans[k].end : last;
+
+        if (start < end) {
+            buffer_append(out, data + (start - col), end - start);
+        }
+    }
+}
+
+/**
+ * @brief apply the mask to the next piece of the input. pieces can split
+ * lines anywhere, the cursor carries the line and col across them
+ * @param mask being applied
+ * @param kept col spans from mask_kept_cols
+ * @param cursor position in the input
+ * @param data of the piece
+ * @param length of the piece
+ * @param out buffer the kept text is appended to
+ */
+void
+mask_feed(const Mask* mask,
+          const SpanList* kept,
+          MaskCursor* cursor,
+          const char* data,
+          size_t length,
+          Buffer* out)
+{
+    const char* end = data + length;
+
+    if (mask->fields.size > 0) {
+        feed_fields(mask, cursor, data, end, out);
+        return;
+    }
+
+    while (data < end) {
+        const char* stop = scan_find(data, end, '\n', '\n');
+
+        if (cursor->keep) {
+            append_kept_cols(kept, data, cursor->col, stop - data, out);
+        }
+        cursor->col += stop - data;
+        cursor->open = true;
+
+        if (stop == end) {
+            break;
+        }
+        if (cursor->keep) {
+            buffer_append(out, "\n", 1);
+        }
+        next_line(mask, cursor);
+        data = stop + 1;
+    }
+}
+
+/**
+ * @brief finish the input, ending a last line that has no newline
+ * @param cursor position at the end of the input
+ * @param out buffer the kept text is appended to
+ */
+void
+mask_finish(const MaskCursor* cursor, Buffer* out)
+{
+    // A last line without a newline still counts as a line.
+    if (cursor->open && cursor->keep) {
+        buffer_append(out, "\n", 1);
+    }
+}
+
+/**
+ * @brief apply the mask as a streaming filter, reading the input a fixed size
+ * block at a time, so memory use doesn't depend on the input size and output
+ * starts before the input is finished. lines longer than a block are written
+ * a piece at a time
+ * @param mask being applied
+ * @param in the input file pointer
+ * @param out the output file pointer
+ */
+void
+mask_stream(const Mask* mask, FILE* in, FILE* out)
+{
+    char* block = malloc(STREAM_BLOCK);
+    SpanList kept = mask_kept_cols(mask);
+    MaskCursor cursor = mask_cursor(mask, 0);
+    Buffer buffer = {.data = NULL, .size = 0, .capacity = 0};
+
+    if (block == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t count;
+    while ((count = fread(block, 1, STREAM_BLOCK, in)) > 0) {
+        mask_feed(mask, &kept, &cursor, block, count, &buffer);
+        fwrite(buffer.data, 1, buffer.size, out);
+        buffer.size = 0;
+    }
+
+    if (ferror(in)) {
+        fprintf(stderr, "Can't read input\n");
+        exit(EXIT_FAILURE);
+    }
+
+    mask_finish(&cursor, &buffer);
+    fwrite(buffer.data, 1, buffer.size, out);
+
+    buffer_destroy(&buffer);
+    free(block);
+    free(kept.spans);
+}
@@ -0,0 +1,251 @@
+#ifndef mask_h
+#define mask_h
+
+/**
+ * @file mask.h
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * compiles chop's line, col and field commands into masks over the original
+ * input
+ */
+#include "pattern.h"
+#include "spanset.h"
+#include "text.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * default delimiter between fields
+ */
+#define DEFAULT_DELIMITER '\t'
+
+/**
+ * a line command that waits for the input: a range of lines, or a match or
+ * nomatch keeping or removing the lines its pattern is found in. a pattern
+ * keeps the cols and fields removed before it, since it is matched against
+ * the lines as they are after those removals
+ */
+typedef struct {
+    long start;
+    long end;
+    bool filter;
+    bool keep;
+    Pattern pattern;
+    SpanList cols;
+    SpanList fields;
+} LineCommand;
+
+/**
+ * the lines, cols and fields removed by a list of commands, in original input
+ * positions. fields are separated by the delimiter. removals are merged into
+ * the sets as the commands are read, and listed once they are all in. line
+ * commands from the first match or nomatch on depend on the input, so they
+ * are kept in order until it is read
+ */
+typedef struct {
+    SpanList lines;
+    SpanList cols;
+    SpanList fields;
+    char delimiter;
+
+    SpanSet removed_lines;
+    SpanSet removed_cols;
+    SpanSet removed_fields;
+
+    LineCommand* commands;
+    int command_count;
+    int command_capacity;
+} Mask;
+
+/**
+ * growable output buffer the mask appends kept text to
+ */
+typedef struct {
+    char* data;
+    size_t size;
+    size_t capacity;
+} Buffer;
+
+/**
+ * position of a pass through the input: the current line and col, the next
+ * removed line span, and whether the current line is kept. with fields, also
+ * the current field, the next removed field span, whether the field is kept
+ * and whether any field of the line has been written yet
+ */
+typedef struct {
+    long line;
+    long col;
+    int span;
+    bool open;
+    bool keep;
+
+    long field;
+    int field_span;
+    bool field_kept;
+    bool emitted;
+} MaskCursor;
+
+/**
+ * @brief create an empty mask that keeps everything, splitting fields at
+ * DEFAULT_DELIMITER
+ * @return the created mask
+ */
+Mask
+mask_create(void);
+
+/**
+ * @brief destroy a mask
+ * @param mask being destroyed
+ */
+void
+mask_destroy(Mask* mask);
+
+/**
+ * @brief remove lines start to end (one based, inclusive), numbered as they
+ * are after every earlier removal, the same as running the commands in order
+ * @param mask to add to
+ * @param start first line to remove
+ * @param end last line to remove
+ */
+void
+mask_remove_lines(Mask* mask, long start, long end);
+
+/**
+ * @brief remove cols start to end (one based, inclusive), numbered as they
+ * are after every earlier removal, the same as running the commands in order
+ * @param mask to add to
+ * @param start first col to remove
+ * @param end last col to remove
+ */
+void
+mask_remove_cols(Mask* mask, long start, long end);
+
+/**
+ * @brief remove fields start to end (one based, inclusive), numbered as they
+ * are after every earlier removal, the same as running the commands in order
+ * @param mask to add to
+ * @param start first field to remove
+ * @param end last field to remove
+ */
+void
+mask_remove_fields(Mask* mask, long start, long end);
+
+/**
+ * @brief keep (match) or remove (nomatch) the lines the pattern is found in,
+ * out of the lines still kept. patterns are matched against the lines as
+ * they are after every earlier col or field removal, the same as running the
+ * commands in order
+ * @param mask to add to
+ * @param source of the pattern
+ * @param keep true to keep the matching lines, false to remove them
+ */
+void
+mask_match_lines(Mask* mask, const char* source, bool keep);
+
+/**
+ * @brief check if the removed lines depend on the input
+ * @param mask being checked
+ * @return true if mask_resolve_lines has to be given the input
+ */
+bool
+mask_needs_input(const Mask* mask);
+
+/**
+ * @brief run the line commands that wait for the input
+ * @param mask being applied
+ * @param text the input
+ * @return every removed line, destroyed by the caller with free(list.spans)
+ */
+SpanList
+mask_resolve_lines(const Mask* mask, const Text* text);
+
+/**
+ * @brief list the removed spans in order, ready for the mask to be applied.
+ * call once after the last removal
+ * @param mask being compiled
+ */
+void
+mask_compile(Mask* mask);
+
+/**
+ * @brief the cols the mask keeps, the last span running to LONG_MAX
+ * @param mask being applied
+ * @return the kept spans, destroyed by the caller with free(list.spans)
+ */
+SpanList
+mask_kept_cols(const Mask* mask);
+
+/**
+ * @brief write the text with the mask applied in a single pass, copying the
+ * kept col spans of each kept line
+ * @param mask being applied
+ * @param text being written
+ * @param fp the file pointer
+ */
+void
+mask_write(const Mask* mask, const Text* text, FILE* fp);
+
+/**
+ * @brief append bytes to a buffer, growing it as needed
+ * @param buffer being appended to
+ * @param data to append
+ * @param length of the data
+ */
+void
+buffer_append(Buffer* buffer, const char* data, size_t length);
+
+/**
+ * @brief release a buffer
+ * @param buffer being destroyed
+ */
+void
+buffer_destroy(Buffer* buffer);
+
+/**
+ * @brief start a cursor at the beginning of a line
+ * @param mask being applied
+ * @param line zero based number of the line the cursor starts on
+ * @return the cursor
+ */
+MaskCursor
+mask_cursor(const Mask* mask, long line);
+
+/**
+ * @brief apply the mask to the next piece of the input. pieces can split
+ * lines anywhere, the cursor carries the line and col across them
+ * @param mask being applied
+ * @param kept col spans from mask_kept_cols, unused with fields
+ * @param cursor position in the input
+ * @param data of the piece
+ * @param length of the piece
+ * @param out buffer the kept text is appended to
+ */
+void
+mask_feed(const Mask* mask,
+          const SpanList* kept,
+          MaskCursor* cursor,
+          const char* data,
+          size_t length,
+          Buffer* out);
+
+/**
+ * @brief finish the input, ending a last line that has no newline
+ * @param cursor position at the end of the input
+ * @param out buffer the kept text is appended to
+ */
+void
+mask_finish(const MaskCursor* cursor, Buffer* out);
+
+/**
+ * @brief apply the mask as a streaming filter, reading the input a fixed size
+ * block at a time, so memory use doesn't depend on the input size and output
+ * starts before the input is finished. lines longer than a block are written
+ * a piece at a time
+ * @param mask being applied
+ * @param in the input file pointer
+ * @param out the output file pointer
+ */
+void
+mask_stream(const Mask* mask, FILE* in, FILE* out);
+
+#endif
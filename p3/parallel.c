@@ -0,0 +1,401 @@
+/**
+ * @file parallel.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * applies a mask to a mapped input on worker threads
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "parallel.h"
+
+#include "lineindex.h"
+#include "mask.h"
+#include "scan.h"
+#include "text.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+
+/**
+ * target size of each chunk of the input, chunks end at the next newline
+ */
+#define CHUNK_SIZE 4194304
+
+/**
+ * finished chunks each worker can get ahead of the writer, this bounds the
+ * memory held by chunk outputs
+ */
+#define WINDOW 2
+
+/**
+ * most chunk outputs written by one writev
+ */
+#define IOV_BATCH 64
+
+/**
+ * one chunk of the input and its masked output
+ */
+typedef struct {
+    size_t start;
+    size_t end;
+    long line;
+    Buffer out;
+    bool done;
+} Chunk;
+
+/**
+ * a range of chunks whose newlines are counted by one thread
+ */
+typedef struct {
+    const Text* text;
+    Chunk* chunks;
+    int first;
+    int last;
+} CountJob;
+
+/**
+ * the chunks shared by the workers and the writer
+ */
+typedef struct {
+    const Mask* mask;
+    const SpanList* kept;
+    const Text* text;
+    Chunk* chunks;
+    int count;
+
+    int next;
+    int written;
+    int window;
+
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} Job;
+
+/**
+ * @brief print an error and exit
+ * @param message to print
+ */
+static void
+fail(const char* message)
+{
+    fprintf(stderr, "%s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief split the text into chunks of about CHUNK_SIZE bytes, each ending
+ * just after a newline or at the end of the text
+ * @param text being split
+ * @param count receives the number of chunks
+ * @return the chunks, freed by the caller
+ */
+static Chunk*
+split_chunks(const Text* text, int* count)
+{
+    Chunk* chunks = malloc((text->size / CHUNK_SIZE + 1) * sizeof(Chunk));
+    if (chunks == NULL) {
+        fail("Out of memory");
+    }
+
+    *count = 0;
+    size_t start = 0;
+
+    while (start < text->size) {
+        size_t end = text->size - start > CHUNK_SIZE ? start + CHUNK_SIZE
+                                                     : text->size;
+        if (end < text->size) {
+            end = scan_skip(text->buffer + end,
+                            text->buffer + text->size,
+                            '\n',
+                            1) -
+                  text->buffer;
+        }
+
+        Chunk chunk = {.start = start,
+                       .end = end,
+                       .line = 0,
+                       .out = {.data = NULL, .size = 0, .capacity = 0},
+                       .done = false};
+        chunks[*count] = chunk;
+        *count += 1;
+        start = end;
+    }
+    return chunks;
+}
+
+/**
+ * @brief count the newlines in a range of chunks, storing each count in the
+ * chunk's line
+ * @param arg the CountJob
+ * @return NULL
+ */
+static void*
+count_newlines(void* arg)
+{
+    CountJob* job = (CountJob*) arg;
+
+    for (int k = job->first; k < job->last; k++) {
+        Chunk* chunk = &job->chunks[k];
+
+        chunk->line = scan_count(job->text->buffer + chunk->start,
+                                 job->text->buffer + chunk->end,
+                                 '\n');
+    }
+    return NULL;
+}
+
+/**
+ * @brief number every chunk with its first line, counting the newlines of the
+ * chunks on threads and then taking a prefix sum of the counts
+ * @param text being split
+ * @param chunks of the text
+ * @param count number of chunks
+ * @param threads number of threads
+ */
+static void
+number_chunks(const Text* text, Chunk chunks[], int count, int threads)
+{
+    threads = threads < count ? threads : count;
+
+    pthread_t workers[threads];
+    CountJob jobs[threads];
+
+    for (int t = 0; t < threads; t++) {
+        jobs[t] = (CountJob){.text = text,
+                             .chunks = chunks,
+                             .first = count * t / threads,
+                             .last = count * (t + 1) / threads};
+    }
+
+    // The calling thread takes the first range itself.
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&workers[t], NULL, count_newlines, &jobs[t]) != 0) {
+            count_newlines(&jobs[t]);
+            workers[t] = pthread_self();
+        }
+    }
+    if (threads > 0) {
+        count_newlines(&jobs[0]);
+    }
+
+    for (int t = 1; t < threads; t++) {
+        if (!pthread_equal(workers[t], pthread_self())) {
+            pthread_join(workers[t], NULL);
+        }
+    }
+
+    long line = 0;
+    for (int k = 0; k < count; k++) {
+        const long lines = chunks[k].line;
+        chunks[k].line = line;
+        line += lines;
+    }
+}
+
+/**
+ * @brief mask one chunk into its output buffer. a chunk that lies inside one
+ * removed line span is skipped without being read
+ * @param job the shared chunks
+ * @param k index of the chunk
+ */
+static void
+apply_chunk(Job* job, int k)
+{
+    Chunk* chunk = &job->chunks[k];
+    MaskCursor cursor = mask_cursor(job->mask, chunk->line);
+
+    const long next_line =
+      k + 1 < job->count ? job->chunks[k + 1].line : LONG_MAX;
+    if (!cursor.keep &&
+        job->mask->lines.spans[cursor.span].end >= next_line) {
+        return;
+    }
+
+    mask_feed(job->mask,
+              job->kept,
+              &cursor,
+              job->text->buffer + chunk->start,
+              chunk->end - chunk->start,
+              &chunk->out);
+    mask_finish(&cursor, &chunk->out);
+}
+
+/**
+ * @brief worker loop, taking chunks in order while staying within the window
+ * of the writer
+ * @param arg the Job
+ * @return NULL
+ */
+static void*
+apply_chunks(void* arg)
+{
+    Job* job = (Job*) arg;
+
+    while (true) {
+        pthread_mutex_lock(&job->lock);
+        while (job->next < job->count &&
+               job->next - job->written >= job->window) {
+            pthread_cond_wait(&job->changed, &job->lock);
+        }
+        if (job->next >= job->count) {
+            pthread_mutex_unlock(&job->lock);
+            return NULL;
+        }
+        const int k = job->next;
+        job->next += 1;
+        pthread_mutex_unlock(&job->lock);
+
+        apply_chunk(job, k);
+
+        pthread_mutex_lock(&job->lock);
+        job->chunks[k].done = true;
+        pthread_cond_broadcast(&job->changed);
+        pthread_mutex_unlock(&job->lock);
+    }
+}
+
+/**
+ * @brief write the outputs of consecutive chunks with writev, retrying short
+ * writes
+ * @param fd the file descriptor
+ * @param chunks being written
+ * @param count number of chunks
+ * @return false if the output couldn't be written
+ */
+static bool
+write_chunks(int fd, Chunk chunks[], int count)
+{
+    struct iovec iov[IOV_BATCH];
+    int size = 0;
+
+    for (int k = 0; k < count; k++) {
+        if (chunks[k].out.size > 0) {
+            iov[size].iov_base = chunks[k].out.data;
+            iov[size].iov_len = chunks[k].out.size;
+            size += 1;
+        }
+    }
+
+    struct iovec* next = iov;
+    while (size > 0) {
+        ssize_t written = writev(fd, next, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        while (size > 0 && (size_t) written >= next->iov_len) {
+            written -= next->iov_len;
+            next += 1;
+            size -= 1;
+        }
+        if (size > 0) {
+            next->iov_base = (char*) next->iov_base + written;
+            next->iov_len -= written;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief apply the mask to the whole text on worker threads. the text is
+ * split into chunks at newlines, each chunk is masked on its own and the
+ * chunk outputs are written in order with writev as they finish
+ * @param mask being applied
+ * @param text being written, no line index needed
+ * @param fp the file pointer
+ * @param threads number of worker threads
+ * @param index of the text, or NULL to count the newlines in every chunk
+ * @return false if the output couldn't be written
+ */
+bool
+mask_write_parallel(const Mask* mask,
+                    const Text* text,
+                    FILE* fp,
+                    int threads,
+                    const LineIndex* index)
+{
+    int count;
+    Chunk* chunks = split_chunks(text, &count);
+    SpanList kept = mask_kept_cols(mask);
+
+    // Line numbers only matter when lines are removed. An index leaves at
+    // most a step of lines to count before each chunk.
+    if (mask->lines.size > 0 && index != NULL) {
+        for (int k = 0; k < count; k++) {
+            chunks[k].line = line_index_line_at(index, text, chunks[k].start);
+        }
+    } else if (mask->lines.size > 0) {
+        number_chunks(text, chunks, count, threads);
+    }
+
+    Job job = {.mask = mask,
+               .kept = &kept,
+               .text = text,
+               .chunks = chunks,
+               .count = count,
+               .next = 0,
+               .written = 0,
+               .window = threads * WINDOW};
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.changed, NULL);
+
+    pthread_t workers[threads];
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        if (pthread_create(&workers[started], NULL, apply_chunks, &job) == 0) {
+            started += 1;
+        }
+    }
+    if (started == 0) {
+        // No threads, so mask everything here before writing.
+        job.window = count;
+        apply_chunks(&job);
+    }
+
+    fflush(fp);
+    const int fd = fileno(fp);
+    bool ok = true;
+
+    // Write finished chunks in order, as many at once as are ready. After a
+    // failed write the rest are still taken so the workers can finish.
+    for (int k = 0; k < count;) {
+        pthread_mutex_lock(&job.lock);
+        while (!chunks[k].done) {
+            pthread_cond_wait(&job.changed, &job.lock);
+        }
+        int last = k;
+        while (last < count && last - k < IOV_BATCH && chunks[last].done) {
+            last += 1;
+        }
+        pthread_mutex_unlock(&job.lock);
+
+        ok = ok && write_chunks(fd, chunks + k, last - k);
+        for (int i = k; i < last; i++) {
+            buffer_destroy(&chunks[i].out);
+        }
+
+        pthread_mutex_lock(&job.lock);
+        job.written = last;
+        pthread_cond_broadcast(&job.changed);
+        pthread_mutex_unlock(&job.lock);
+        k = last;
+    }
+
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t], NULL);
+    }
+
+    pthread_mutex_destroy(&job.lock);
+    pthread_cond_destroy(&job.changed);
+    free(kept.spans);
+    free(chunks);
+    return ok;
+}
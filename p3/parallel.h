@@ -0,0 +1,33 @@
+#ifndef parallel_h
+#define parallel_h
+
+/**
+ * @file parallel.h
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * applies a mask to a mapped input on worker threads
+ */
+#include "lineindex.h"
+#include "mask.h"
+#include "text.h"
+
+#include <stdio.h>
+
+/**
+ * @brief apply the mask to the whole text on worker threads. the text is
+ * split into chunks at newlines, each chunk is masked on its own and the
+ * chunk outputs are written in order with writev as they finish
+ * @param mask being applied
+ * @param text being written, no line index needed
+ * @param fp the file pointer
+ * @param threads number of worker threads
+ * @param index of the text, or NULL to count the newlines in every chunk
+ * @return false if the output couldn't be written
+ */
+bool
+mask_write_parallel(const Mask* mask,
+                    const Text* text,
+                    FILE* fp,
+                    int threads,
+                    const LineIndex* index);
+
+#endif
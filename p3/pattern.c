@@ -0,0 +1,148 @@
+/**
+ * @file pattern.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * finds the lines containing a literal, optionally anchored to the start or
+ * end of the line
+ */
+#include "pattern.h"
+
+#include "scan.h"
+#include "spanset.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief compile a pattern
+ * @param source of the pattern, such as ^ERROR or .log$
+ * @return the compiled pattern
+ */
+Pattern
+pattern_create(const char* source)
+{
+    const bool at_start = source[0] == '^';
+    const char* body = source + at_start;
+    size_t length = strlen(body);
+    const bool at_end = length > 0 && body[length - 1] == '$';
+    length -= at_end;
+
+    // Only ^$ needs the anchor at the end of an empty literal, every line
+    // ends with one.
+    Pattern pattern = {.literal = malloc(length + 1),
+                       .length = length,
+                       .at_start = at_start,
+                       .at_end = at_end && (length > 0 || at_start)};
+    if (pattern.literal == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(pattern.literal, body, length);
+    pattern.literal[length] = '\0';
+
+    return pattern;
+}
+
+/**
+ * @brief find the next place the pattern could match. a literal of two or
+ * more bytes is found by its first two bytes, one anchored to the start of
+ * the line by a newline and its first byte
+ * @param pattern being matched
+ * @param data start of the text
+ * @param p where to look from, the start of a line when the literal is empty
+ * @param end one past the last byte
+ * @return the candidate, or end if there are no more
+ */
+static const char*
+next_candidate(const Pattern* pattern,
+               const char* data,
+               const char* p,
+               const char* end)
+{
+    const char* literal = pattern->literal;
+
+    if (pattern->length == 0) {
+        return p;
+    } else if (pattern->at_start) {
+        if (p == data && *p == literal[0]) {
+            return p;
+        }
+        const char* from = p == data ? p : p - 1;
+        const char* pair = scan_pair(from, end, '\n', literal[0]);
+        return pair == end ? end : pair + 1;
+    } else if (pattern->length == 1) {
+        return scan_find(p, end, literal[0], literal[0]);
+    } else {
+        return scan_pair(p, end, literal[0], literal[1]);
+    }
+}
+
+/**
+ * @brief find the lines that match the pattern. candidates are found by
+ * scanning for the first two bytes of the literal a block at a time, and only
+ * those are compared in full
+ * @param pattern being matched
+ * @param data start of the text
+ * @param size of the text
+ * @param line_count receives the number of lines in the text
+ * @return the matching lines, zero based, destroyed by the caller with
+ * free(list.spans)
+ */
+SpanList
+pattern_lines(const Pattern* pattern,
+              const char* data,
+              size_t size,
+              long* line_count)
+{
+    SpanList lines = span_list_create();
+    const char* end = data + size;
+    const char* counted = data;
+    const char* p = data;
+    long line = 0;
+
+    while (p < end) {
+        const char* candidate = next_candidate(pattern, data, p, end);
+        if (candidate == end) {
+            break;
+        }
+
+        // Newlines are only counted up to each candidate.
+        line += scan_count(counted, candidate, '\n');
+        counted = candidate;
+
+        const char* line_end = scan_find(candidate, end, '\n', '\n');
+        const char* match_end = candidate + pattern->length;
+        const bool matched =
+          match_end <= line_end &&
+          memcmp(candidate, pattern->literal, pattern->length) == 0 &&
+          (!pattern->at_end || match_end == line_end);
+
+        if (matched) {
+            // The rest of the line doesn't matter, go on from the next one.
+            span_list_push(&lines, line, line + 1);
+            p = line_end < end ? line_end + 1 : end;
+            line += line_end < end;
+            counted = p;
+        } else if (pattern->length == 0) {
+            p = line_end < end ? line_end + 1 : end;
+        } else {
+            p = candidate + 1;
+        }
+    }
+
+    line += scan_count(counted, end, '\n');
+    *line_count = line + (size > 0 && data[size - 1] != '\n');
+    return lines;
+}
+
+/**
+ * @brief destroy a pattern
+ * @param pattern being destroyed
+ */
+void
+pattern_destroy(Pattern* pattern)
+{
+    free(pattern->literal);
+    pattern->literal = NULL;
+}
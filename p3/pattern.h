@@ -0,0 +1,58 @@
+#ifndef pattern_h
+#define pattern_h
+
+/**
+ * @file pattern.h
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * finds the lines containing a literal, optionally anchored to the start or
+ * end of the line
+ */
+#include "spanset.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * a literal that a line must contain. a leading ^ anchors it to the start of
+ * the line and a trailing $ to the end, everything else matches itself
+ */
+typedef struct {
+    char* literal;
+    size_t length;
+    bool at_start;
+    bool at_end;
+} Pattern;
+
+/**
+ * @brief compile a pattern
+ * @param source of the pattern, such as ^ERROR or .log$
+ * @return the compiled pattern
+ */
+Pattern
+pattern_create(const char* source);
+
+/**
+ * @brief find the lines that match the pattern. candidates are found by
+ * scanning for the first two bytes of the literal a block at a time, and only
+ * those are compared in full
+ * @param pattern being matched
+ * @param data start of the text
+ * @param size of the text
+ * @param line_count receives the number of lines in the text
+ * @return the matching lines, zero based, destroyed by the caller with
+ * free(list.spans)
+ */
+SpanList
+pattern_lines(const Pattern* pattern,
+              const char* data,
+              size_t size,
+              long* line_count);
+
+/**
+ * @brief destroy a pattern
+ * @param pattern being destroyed
+ */
+void
+pattern_destroy(Pattern* pattern);
+
+#endif
@@ -0,0 +1,227 @@
+/**
+ * @file scan.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * finds newlines and delimiters a 64 byte block at a time
+ */
+#include "scan.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * bytes compared per block, one bit each in a block mask
+ */
+#define BLOCK 64
+
+/**
+ * @brief compare a block of BLOCK bytes against a and b. uses AVX2 when built
+ * with -mavx2, SSE2 on any other x86-64 build and plain compares elsewhere
+ * @param p start of the block
+ * @param a byte to find
+ * @param b other byte to find
+ * @return bit i set if byte i is a or b
+ */
+static inline uint64_t
+block_mask(const char* p, char a, char b)
+{
+#if defined(__AVX2__)
+    const __m256i va = _mm256_set1_epi8(a);
+    const __m256i vb = _mm256_set1_epi8(b);
+    uint64_t mask = 0;
+
+    for (int k = 0; k < BLOCK; k += 32) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*) (p + k));
+        const __m256i eq =
+          _mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb));
+        mask |= (uint64_t) (uint32_t) _mm256_movemask_epi8(eq) << k;
+    }
+    return mask;
+#elif defined(__SSE2__)
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    uint64_t mask = 0;
+
+    for (int k = 0; k < BLOCK; k += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i*) (p + k));
+        const __m128i eq =
+          _mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb));
+        mask |= (uint64_t) (uint16_t) _mm_movemask_epi8(eq) << k;
+    }
+    return mask;
+#else
+    uint64_t mask = 0;
+
+    for (int k = 0; k < BLOCK; k++) {
+        mask |= (uint64_t) (p[k] == a || p[k] == b) << k;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * @brief find the first byte equal to a or b. pass the same byte twice to
+ * look for just one
+ * @param data start of the bytes
+ * @param end one past the last byte
+ * @param a byte to find, such as a newline
+ * @param b other byte to find, such as a delimiter
+ * @return the first match, or end if there is none
+ */
+const char*
+scan_find(const char* data, const char* end, char a, char b)
+{
+    for (; end - data >= BLOCK; data += BLOCK) {
+        const uint64_t mask = block_mask(data, a, b);
+        if (mask != 0) {
+            return data + __builtin_ctzll(mask);
+        }
+    }
+    for (; data < end; data++) {
+        if (*data == a || *data == b) {
+            return data;
+        }
+    }
+    return end;
+}
+
+/**
+ * @brief find the first place byte a is followed by byte b, the prefilter
+ * for a literal that starts with them
+ * @param data start of the bytes
+ * @param end one past the last byte
+ * @param a first byte to find
+ * @param b byte that must follow it
+ * @return the a of the first pair, or end if there is none
+ */
+const char*
+scan_pair(const char* data, const char* end, char a, char b)
+{
+    // The second compare reads one byte past the block.
+    for (; end - data > BLOCK; data += BLOCK) {
+        const uint64_t mask =
+          block_mask(data, a, a) & block_mask(data + 1, b, b);
+        if (mask != 0) {
+            return data + __builtin_ctzll(mask);
+        }
+    }
+    for (; end - data >= 2; data++) {
+        if (data[0] == a && data[1] == b) {
+            return data;
+        }
+    }
+    return end;
+}
+
+/**
+ * @brief count the bytes equal to c
+ * @param data start of the bytes
+ * @param end one past the last byte
+ * @param c byte to count
+ * @return the count
+ */
+long
+scan_count(const char* data, const char* end, char c)
+{
+    long count = 0;
+
+    for (; end - data >= BLOCK; data += BLOCK) {
+        count += __builtin_popcountll(block_mask(data, c, c));
+    }
+    for (; data < end; data++) {
+        count += *data == c;
+    }
+    return count;
+}
+
+/**
+ * @brief skip past count bytes equal to c
+ * @param data start of the bytes
+ * @param end one past the last byte
+ * @param c byte to skip past
+ * @param count number of matches to skip
+ * @return just past the count-th match, or end if there are fewer
+ */
+const char*
+scan_skip(const char* data, const char* end, char c, long count)
+{
+    if (count <= 0) {
+        return data;
+    }
+
+    for (; end - data >= BLOCK; data += BLOCK) {
+        uint64_t mask = block_mask(data, c, c);
+        const int found = __builtin_popcountll(mask);
+
+        if (found < count) {
+            count -= found;
+            continue;
+        }
+        // Drop the matches before the count-th, then take the lowest bit.
+        for (long i = 1; i < count; i++) {
+            mask &= mask - 1;
+        }
+        return data + __builtin_ctzll(mask) + 1;
+    }
+    for (; data < end; data++) {
+        if (*data == c && --count == 0) {
+            return data + 1;
+        }
+    }
+    return end;
+}
+
+/**
+ * @brief record where the bytes equal to c are, up to max of them
+ * @param data start of the bytes
+ * @param end one past the last byte
+ * @param c byte to find
+ * @param positions receives the offsets of the matches from data
+ * @param max capacity of positions
+ * @param next receives where to resume: the first match not recorded, or end
+ * @return the number of positions recorded
+ */
+size_t
+scan_positions(const char* data,
+               const char* end,
+               char c,
+               size_t positions[],
+               size_t max,
+               const char** next)
+{
+    const char* start = data;
+    size_t size = 0;
+
+    for (; end - data >= BLOCK; data += BLOCK) {
+        uint64_t mask = block_mask(data, c, c);
+
+        while (mask != 0) {
+            const int bit = __builtin_ctzll(mask);
+            if (size == max) {
+                *next = data + bit;
+                return size;
+            }
+            positions[size] = (size_t) (data - start) + bit;
+            size += 1;
+            mask &= mask - 1;
+        }
+    }
+    for (; data < end; data++) {
+        if (*data == c) {
+            if (size == max) {
+                *next = data;
+                return size;
+            }
+            positions[size] = (size_t) (data - start);
+            size += 1;
+        }
+    }
+
+    *next = end;
+    return size;
+}
@@ -0,0 +1,74 @@
+#ifndef scan_h
+#define scan_h
+
+/**
+ * @file scan.h
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * finds newlines and delimiters a 64 byte block at a time
+ */
+#include <stddef.h>
+
+/**
+ * @brief find the first byte equal to a or b. pass the same byte twice to
+ * look for just one
+ * @param data start of the bytes
+ * @param end one past the last byte
+ * @param a byte to find, such as a newline
+ * @param b other byte to find, such as a delimiter
+ * @return the first match, or end if there is none
+ */
+const char*
+scan_find(const char* data, const char* end, char a, char b);
+
+/**
+ * @brief find the first place byte a is followed by byte b, the prefilter
+ * for a literal that starts with them
+ * @param data start of the bytes
+ * @param end one past the last byte
+ * @param a first byte to find
+ * @param b byte that must follow it
+ * @return the a of the first pair, or end if there is none
+ */
+const char*
+scan_pair(const char* data, const char* end, char a, char b);
+
+/**
+ * @brief count the bytes equal to c
+ * @param data start of the bytes
+ * @param end one past the last byte
+ * @param c byte to count
+ * @return the count
+ */
+long
+scan_count(const char* data, const char* end, char c);
+
+/**
+ * @brief skip past count bytes equal to c
+ * @param data start of the bytes
+ * @param end one past the last byte
+ * @param c byte to skip past
+ * @param count number of matches to skip
+ * @return just past the count-th match, or end if there are fewer
+ */
+const char*
+scan_skip(const char* data, const char* end, char c, long count);
+
+/**
+ * @brief record where the bytes equal to c are, up to max of them
+ * @param data start of the bytes
+ * @param end one past the last byte
+ * @param c byte to find
+ * @param positions receives the offsets of the matches from data
+ * @param max capacity of positions
+ * @param next receives where to resume: the first match not recorded, or end
+ * @return the number of positions recorded
+ */
+size_t
+scan_positions(const char* data,
+               const char* end,
+               char c,
+               size_t positions[],
+               size_t max,
+               const char** next);
+
+#endif
@@ -0,0 +1,439 @@
+/**
+ * @file spanset.c
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * sorted sets of removed spans, merged as they are added
+ */
+#include "spanset.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * no node, an empty tree
+ */
+#define NONE -1
+
+/**
+ * initial capacity of a span list
+ */
+#define SPAN_CAPACITY 8
+
+/**
+ * initial capacity of the node array
+ */
+#define NODE_CAPACITY 8
+
+/**
+ * seed of the random numbers used to balance the tree
+ */
+#define SEED 2463534242u
+
+/**
+ * @brief create an empty span list
+ * @return the created list
+ */
+SpanList
+span_list_create(void)
+{
+    SpanList list = {.spans = malloc(SPAN_CAPACITY * sizeof(Span)),
+                     .size = 0,
+                     .capacity = SPAN_CAPACITY};
+    return list;
+}
+
+/**
+ * @brief append a span, merging it into the last span if they touch. spans
+ * must be pushed in order of start
+ * @param list to append to
+ * @param start of the span
+ * @param end of the span
+ */
+void
+span_list_push(SpanList* list, long start, long end)
+{
+    if (start >= end) {
+        return;
+    }
+    if (list->size > 0 && list->spans[list->size - 1].end >= start) {
+        Span* last = &list->spans[list->size - 1];
+        last->end = end > last->end ? end : last->end;
+        return;
+    }
+    if (list->size == list->capacity) {
+        list->capacity *= 2;
+        Span* spans = realloc(list->spans, list->capacity * sizeof(Span));
+        if (spans == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        list->spans = spans;
+    }
+    Span span = {.start = start, .end = end};
+    list->spans[list->size] = span;
+    list->size += 1;
+}
+
+/**
+ * @brief next xorshift random number
+ * @param set holding the seed
+ * @return the random number
+ */
+static unsigned int
+next_random(SpanSet* set)
+{
+    set->seed ^= set->seed << 13;
+    set->seed ^= set->seed >> 17;
+    set->seed ^= set->seed << 5;
+    return set->seed;
+}
+
+/**
+ * @brief total positions removed by a subtree
+ * @param set holding the nodes
+ * @param t root of the subtree
+ * @return the positions
+ */
+static long
+removed(const SpanSet* set, int t)
+{
+    return t == NONE ? 0 : set->nodes[t].removed;
+}
+
+/**
+ * @brief total spans of a subtree
+ * @param set holding the nodes
+ * @param t root of the subtree
+ * @return the spans
+ */
+static int
+count(const SpanSet* set, int t)
+{
+    return t == NONE ? 0 : set->nodes[t].count;
+}
+
+/**
+ * @brief recompute the totals of a node from its children
+ * @param set holding the nodes
+ * @param t the node
+ */
+static void
+update(SpanSet* set, int t)
+{
+    SpanNode* node = &set->nodes[t];
+
+    node->removed = removed(set, node->left) + (node->end - node->start) +
+                    removed(set, node->right);
+    node->count = count(set, node->left) + 1 + count(set, node->right);
+}
+
+/**
+ * @brief add a node with no children, reusing a dropped node if there is
+ * one. this can move the node array, so no pointer into it is valid after
+ * the call
+ * @param set to add to
+ * @param start of the span
+ * @param end of the span
+ * @return index of the node
+ */
+static int
+new_node(SpanSet* set, long start, long end)
+{
+    SpanNode node = {.start = start,
+                     .end = end,
+                     .left = NONE,
+                     .right = NONE,
+                     .removed = end - start,
+                     .count = 1};
+
+    if (set->free_node != NONE) {
+        const int t = set->free_node;
+        set->free_node = set->nodes[t].left;
+        set->nodes[t] = node;
+        return t;
+    }
+
+    if (set->size == set->capacity) {
+        set->capacity *= 2;
+        SpanNode* nodes =
+          realloc(set->nodes, set->capacity * sizeof(SpanNode));
+        if (nodes == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        set->nodes = nodes;
+    }
+
+    set->nodes[set->size] = node;
+    set->size += 1;
+    return set->size - 1;
+}
+
+/**
+ * @brief put every node of a subtree on the free list
+ * @param set holding the nodes
+ * @param t root of the subtree
+ */
+static void
+drop_nodes(SpanSet* set, int t)
+{
+    if (t == NONE) {
+        return;
+    }
+    drop_nodes(set, set->nodes[t].left);
+    drop_nodes(set, set->nodes[t].right);
+    set->nodes[t].left = set->free_node;
+    set->free_node = t;
+}
+
+/**
+ * @brief join two trees, every span of a before every span of b. the root is
+ * picked at random weighted by size, which keeps the tree balanced
+ * @param set holding the nodes
+ * @param a left tree
+ * @param b right tree
+ * @return root of the joined tree
+ */
+static int
+merge(SpanSet* set, int a, int b)
+{
+    if (a == NONE) {
+        return b;
+    } else if (b == NONE) {
+        return a;
+    }
+
+    if (next_random(set) % (count(set, a) + count(set, b)) <
+        (unsigned int) count(set, a)) {
+        const int right = merge(set, set->nodes[a].right, b);
+        set->nodes[a].right = right;
+        update(set, a);
+        return a;
+    } else {
+        const int left = merge(set, a, set->nodes[b].left);
+        set->nodes[b].left = left;
+        update(set, b);
+        return b;
+    }
+}
+
+/**
+ * @brief split a tree before the first span starting at or after key
+ * @param set holding the nodes
+ * @param t tree being split
+ * @param key first start of the right tree
+ * @param left receives the spans starting before key
+ * @param right receives the rest
+ */
+static void
+split(SpanSet* set, int t, long key, int* left, int* right)
+{
+    if (t == NONE) {
+        *left = NONE;
+        *right = NONE;
+        return;
+    }
+
+    int middle;
+
+    if (key <= set->nodes[t].start) {
+        split(set, set->nodes[t].left, key, left, &middle);
+        set->nodes[t].left = middle;
+        update(set, t);
+        *right = t;
+    } else {
+        split(set, set->nodes[t].right, key, &middle, right);
+        set->nodes[t].right = middle;
+        update(set, t);
+        *left = t;
+    }
+}
+
+/**
+ * @brief the last span of a tree
+ * @param set holding the nodes
+ * @param t a tree with at least one span
+ * @return index of the node
+ */
+static int
+last_node(const SpanSet* set, int t)
+{
+    while (set->nodes[t].right != NONE) {
+        t = set->nodes[t].right;
+    }
+    return t;
+}
+
+/**
+ * @brief create an empty set
+ * @return the created set
+ */
+SpanSet
+span_set_create(void)
+{
+    SpanSet set = {.nodes = malloc(NODE_CAPACITY * sizeof(SpanNode)),
+                   .size = 0,
+                   .capacity = NODE_CAPACITY,
+                   .root = NONE,
+                   .free_node = NONE,
+                   .seed = SEED};
+    return set;
+}
+
+/**
+ * @brief copy a set, so more spans can be added without changing the original
+ * @param set being copied
+ * @return the copy
+ */
+SpanSet
+span_set_copy(const SpanSet* set)
+{
+    SpanSet copy = *set;
+
+    copy.nodes = malloc(set->capacity * sizeof(SpanNode));
+    if (copy.nodes == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(copy.nodes, set->nodes, set->size * sizeof(SpanNode));
+    return copy;
+}
+
+/**
+ * @brief add the span start to end, merging it with the spans it overlaps or
+ * touches
+ * @param set to add to
+ * @param start first position of the span
+ * @param end one past the last position
+ */
+void
+span_set_add(SpanSet* set, long start, long end)
+{
+    if (start >= end) {
+        return;
+    }
+
+    int before;
+    int after;
+    int rest;
+    int covered;
+
+    split(set, set->root, start, &before, &after);
+
+    // The last span starting before this one may reach it.
+    if (before != NONE && set->nodes[last_node(set, before)].end >= start) {
+        const int touching = last_node(set, before);
+        start = set->nodes[touching].start;
+        end = end > set->nodes[touching].end ? end : set->nodes[touching].end;
+        split(set, before, start, &before, &covered);
+        drop_nodes(set, covered);
+    }
+
+    // Every span starting inside this one, or just at its end, is merged in.
+    // Their nodes are dropped, so each span is merged at most once.
+    split(set, after, end + 1, &covered, &rest);
+    if (covered != NONE && set->nodes[last_node(set, covered)].end > end) {
+        end = set->nodes[last_node(set, covered)].end;
+    }
+    drop_nodes(set, covered);
+
+    const int node = new_node(set, start, end);
+    set->root = merge(set, merge(set, before, node), rest);
+}
+
+/**
+ * @brief find the original position of a kept position, numbered as it is
+ * once the spans in the set are taken out
+ * @param set of removed spans in original positions
+ * @param position being found
+ * @return the original position
+ */
+static long
+original(const SpanSet* set, long position)
+{
+    long before = 0;
+
+    // A span comes before the position when fewer kept positions come before
+    // its start than the position's number.
+    for (int t = set->root; t != NONE;) {
+        const SpanNode* node = &set->nodes[t];
+        const long removed_before = before + removed(set, node->left);
+
+        if (position < node->start - removed_before) {
+            t = node->left;
+        } else {
+            before = removed_before + (node->end - node->start);
+            t = node->right;
+        }
+    }
+    return position + before;
+}
+
+/**
+ * @brief remove the positions start to end (zero based, end exclusive),
+ * numbered as they are once the spans already in the set are taken out. the
+ * kept positions between them are one span of original positions, so this
+ * is a single add
+ * @param set of removed spans in original positions
+ * @param start first position to remove
+ * @param end one past the last position to remove
+ */
+void
+span_set_remove_shifted(SpanSet* set, long start, long end)
+{
+    if (start >= end) {
+        return;
+    }
+    span_set_add(set, original(set, start), original(set, end - 1) + 1);
+}
+
+/**
+ * @brief append the spans of a subtree to a list in order
+ * @param set holding the nodes
+ * @param t root of the subtree
+ * @param list being appended to, already big enough
+ */
+static void
+collect(const SpanSet* set, int t, SpanList* list)
+{
+    if (t == NONE) {
+        return;
+    }
+    collect(set, set->nodes[t].left, list);
+    Span span = {.start = set->nodes[t].start, .end = set->nodes[t].end};
+    list->spans[list->size] = span;
+    list->size += 1;
+    collect(set, set->nodes[t].right, list);
+}
+
+/**
+ * @brief the spans of the set in order
+ * @param set being listed
+ * @return the spans, destroyed by the caller with free(list.spans)
+ */
+SpanList
+span_set_list(const SpanSet* set)
+{
+    const int size = count(set, set->root);
+    SpanList list = {.spans = malloc((size > 0 ? size : 1) * sizeof(Span)),
+                     .size = 0,
+                     .capacity = size > 0 ? size : 1};
+
+    collect(set, set->root, &list);
+    return list;
+}
+
+/**
+ * @brief destroy the set
+ * @param set being destroyed
+ */
+void
+span_set_destroy(SpanSet* set)
+{
+    free(set->nodes);
+    set->nodes = NULL;
+    set->size = 0;
+    set->capacity = 0;
+    set->root = NONE;
+    set->free_node = NONE;
+}
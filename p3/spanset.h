@@ -0,0 +1,126 @@
+#ifndef spanset_h
+#define spanset_h
+
+/**
+ * @file spanset.h
+ * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
+ * sorted sets of removed spans, merged as they are added
+ */
+#include <stdio.h>
+
+/**
+ * span of positions from start (inclusive) to end (exclusive), zero based
+ */
+typedef struct {
+    long start;
+    long end;
+} Span;
+
+/**
+ * sorted, non overlapping, non adjacent spans
+ */
+typedef struct {
+    Span* spans;
+    int size;
+    int capacity;
+} SpanList;
+
+/**
+ * one span of a set, and a node of the tree holding the spans in order.
+ * subtree totals let a position numbered after the removals be found without
+ * walking the spans before it
+ */
+typedef struct {
+    long start;
+    long end;
+    int left;
+    int right;
+    long removed;
+    int count;
+} SpanNode;
+
+/**
+ * sorted, non overlapping, non adjacent spans in a tree, so adding a span
+ * takes logarithmic time however many spans there are. nodes of merged spans
+ * are chained through left from free_node and reused before the array grows,
+ * so it holds about as many nodes as the set has spans
+ */
+typedef struct {
+    SpanNode* nodes;
+    int size;
+    int capacity;
+    int root;
+    int free_node;
+    unsigned int seed;
+} SpanSet;
+
+/**
+ * @brief create an empty span list
+ * @return the created list
+ */
+SpanList
+span_list_create(void);
+
+/**
+ * @brief append a span, merging it into the last span if they touch. spans
+ * must be pushed in order of start
+ * @param list to append to
+ * @param start of the span
+ * @param end of the span
+ */
+void
+span_list_push(SpanList* list, long start, long end);
+
+/**
+ * @brief create an empty set
+ * @return the created set
+ */
+SpanSet
+span_set_create(void);
+
+/**
+ * @brief copy a set, so more spans can be added without changing the original
+ * @param set being copied
+ * @return the copy
+ */
+SpanSet
+span_set_copy(const SpanSet* set);
+
+/**
+ * @brief add the span start to end, merging it with the spans it overlaps or
+ * touches
+ * @param set to add to
+ * @param start first position of the span
+ * @param end one past the last position
+ */
+void
+span_set_add(SpanSet* set, long start, long end);
+
+/**
+ * @brief remove the positions start to end (zero based, end exclusive),
+ * numbered as they are once the spans already in the set are taken out. the
+ * kept positions between them are one span of original positions, so this
+ * is a single add
+ * @param set of removed spans in original positions
+ * @param start first position to remove
+ * @param end one past the last position to remove
+ */
+void
+span_set_remove_shifted(SpanSet* set, long start, long end);
+
+/**
+ * @brief the spans of the set in order
+ * @param set being listed
+ * @return the spans, destroyed by the caller with free(list.spans)
+ */
+SpanList
+span_set_list(const SpanSet* set);
+
+/**
+ * @brief destroy the set
+ * @param set being destroyed
+ */
+void
+span_set_destroy(SpanSet* set);
+
+#endif
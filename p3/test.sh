@@ -162,13 +162,13 @@ if [ -x chop ] ; then
     echo "Test 17: ./chop col 1 line 1 input-e.txt output.txt > stdout.txt 2> stderr.txt"
     ./chop col 1 line 1 input-e.txt output.txt > stdout.txt 2> stderr.txt
     STATUS=$?
-    checkResults 17 1 $STATUS
+    checkResults 17 0 $STATUS
 
     rm -f output.txt stdout.txt stderr.txt
     echo "Test 18: ./chop col 1 line 1 input-f.txt output.txt > stdout.txt 2> stderr.txt"
     ./chop col 1 line 1 input-f.txt output.txt > stdout.txt 2> stderr.txt
     STATUS=$?
-    checkResults 18 1 $STATUS
+    checkResults 18 0 $STATUS
     
     rm -f output.txt stdout.txt stderr.txt
     echo "Test 19: ./chop col 1 line 1 not-a-file.txt output.txt > stdout.txt 2> stderr.txt"
@@ -193,6 +193,179 @@ if [ -x chop ] ; then
     ./chop lines 5 seven input-a.txt output.txt > stdout.txt 2> stderr.txt
     STATUS=$?
     checkResults 22 1 $STATUS
+
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 23: cat input-c.txt | ./chop lines 22 38 cols 22 31 lines 55 63 - output.txt > stdout.txt 2> stderr.txt"
+    cat input-c.txt | ./chop lines 22 38 cols 22 31 lines 55 63 - output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 23 0 $STATUS
+
+    rm -f output.txt stdout.txt stderr.txt
+    cp input-b.txt output.txt
+    echo "Test 24: ./chop line 1 cols 13 17 output.txt output.txt > stdout.txt 2> stderr.txt"
+    ./chop line 1 cols 13 17 output.txt output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 24 0 $STATUS
+
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 25: ./chop -j 2 lines 22 38 lines 49 61 cols 22 31 lines 55 63 input-c.txt output.txt > stdout.txt 2> stderr.txt"
+    ./chop -j 2 lines 22 38 lines 49 61 cols 22 31 lines 55 63 input-c.txt output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 25 0 $STATUS
+
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 26: ./chop -j 0 line 1 input-a.txt output.txt > stdout.txt 2> stderr.txt"
+    ./chop -j 0 line 1 input-a.txt output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 26 1 $STATUS
+
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 27: ./chop -d , line 1 fields 3 4 field 3 input-g.txt output.txt > stdout.txt 2> stderr.txt"
+    ./chop -d , line 1 fields 3 4 field 3 input-g.txt output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 27 0 $STATUS
+
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 28: ./chop -d , field 2 col 3 input-g.txt output.txt > stdout.txt 2> stderr.txt"
+    ./chop -d , field 2 col 3 input-g.txt output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 28 1 $STATUS
+
+    # Copying the kept lines of a large input scans it up to the last removed
+    # line. That is most of the file here, so the copy saves the line index
+    # beside the input. The threaded run builds one too, and the next copy
+    # seeks with it.
+    seq 1 300000 > input-h.txt
+    rm -f input-h.txt.chopidx output.txt stdout.txt stderr.txt
+    echo "Test 29: ./chop lines 3 299998 input-h.txt output.txt > stdout.txt 2> stderr.txt"
+    ./chop lines 3 299998 input-h.txt output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    if [ -f input-h.txt.chopidx ]; then
+        checkResults 29 0 $STATUS
+    else
+        echo "**** Test 29 FAILED - no line index was written for input-h.txt"
+        FAIL=1
+    fi
+
+    rm -f input-h.txt.chopidx output.txt stdout.txt stderr.txt
+    echo "Test 30: ./chop -j 2 line 1 lines 5 299996 cols 2 4 input-h.txt output.txt > stdout.txt 2> stderr.txt"
+    ./chop -j 2 line 1 lines 5 299996 cols 2 4 input-h.txt output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    if [ -f input-h.txt.chopidx ]; then
+        checkResults 30 0 $STATUS
+    else
+        echo "**** Test 30 FAILED - no line index was written for input-h.txt"
+        FAIL=1
+    fi
+
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 37: ./chop lines 3 299998 input-h.txt output.txt > stdout.txt 2> stderr.txt"
+    ./chop lines 3 299998 input-h.txt output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 37 0 $STATUS
+    rm -f input-h.txt input-h.txt.chopidx
+
+    rm -rf batch-out output.txt stdout.txt stderr.txt
+    echo "Test 31: ./chop line 1 cols 1 2 --batch batch-out input-a.txt input-b.txt > stdout.txt 2> stderr.txt"
+    ./chop line 1 cols 1 2 --batch batch-out input-a.txt input-b.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    cat batch-out/input-a.txt batch-out/input-b.txt > output.txt 2> /dev/null
+    checkResults 31 0 $STATUS
+
+    rm -rf batch-out output.txt stdout.txt stderr.txt
+    echo "Test 32: printf 'input-c.txt\\ninput-z.txt\\n' | ./chop -j 2 lines 2 5 --batch batch-out - > stdout.txt 2> stderr.txt"
+    printf 'input-c.txt\ninput-z.txt\n' | ./chop -j 2 lines 2 5 --batch batch-out - > stdout.txt 2> stderr.txt
+    STATUS=$?
+    cat batch-out/input-c.txt > output.txt 2> /dev/null
+    checkResults 32 1 $STATUS
+    rm -rf batch-out
+
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 33: ./chop line 2 lines 5 10 lines 3 7 cols 4 6 cols 2 5 col 1 input-c.txt output.txt > stdout.txt 2> stderr.txt"
+    ./chop line 2 lines 5 10 lines 3 7 cols 4 6 cols 2 5 col 1 input-c.txt output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 33 0 $STATUS
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 34: ./chop match 'Blue ' nomatch '^Light' line 2 cols 21 31 input-c.txt output.txt > stdout.txt 2> stderr.txt"
+    ./chop match 'Blue ' nomatch '^Light' line 2 cols 21 31 input-c.txt output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 34 0 $STATUS
+
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 35: cat input-c.txt | ./chop nomatch '100%$' match '#F' - output.txt > stdout.txt 2> stderr.txt"
+    cat input-c.txt | ./chop nomatch '100%$' match '#F' - output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 35 0 $STATUS
+
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 36: ./chop line 1 \$'input-\\xff.txt' output.txt > stdout.txt 2> stderr.txt"
+    cp input-a.txt $'input-\xff.txt'
+    ./chop line 1 $'input-\xff.txt' output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    rm -f $'input-\xff.txt'
+    checkResults 36 0 $STATUS
+
+    # Inputs sharing a base name would overwrite each other's output.
+    rm -rf batch-out output.txt stdout.txt stderr.txt
+    echo "Test 38: ./chop line 1 --batch batch-out input-a.txt ./input-a.txt > stdout.txt 2> stderr.txt"
+    ./chop line 1 --batch batch-out input-a.txt ./input-a.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    if [ -d batch-out ]; then
+        echo "**** Test 38 FAILED - files were chopped despite a duplicate output name"
+        FAIL=1
+    else
+        checkResults 38 1 $STATUS
+    fi
+
+    # An output that can't be written fails just its own file.
+    rm -rf batch-out output.txt stdout.txt stderr.txt
+    mkdir batch-out
+    ln -s /dev/full batch-out/input-a.txt
+    echo "Test 39: ./chop -j 2 line 1 --batch batch-out input-a.txt input-b.txt > stdout.txt 2> stderr.txt"
+    ./chop -j 2 line 1 --batch batch-out input-a.txt input-b.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    cat batch-out/input-b.txt > output.txt 2> /dev/null
+    checkResults 39 1 $STATUS
+    rm -rf batch-out
+
+    # The same for a streamed file, written in blocks larger than the
+    # output's buffer.
+    seq 1 100000 > input-h.txt
+    rm -rf batch-out output.txt stdout.txt stderr.txt
+    mkdir batch-out
+    ln -s /dev/full batch-out/input-h.txt
+    echo "Test 42: ./chop -j 2 cols 1 2 --batch batch-out input-h.txt input-b.txt > stdout.txt 2> stderr.txt"
+    ./chop -j 2 cols 1 2 --batch batch-out input-h.txt input-b.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    cat batch-out/input-b.txt > output.txt 2> /dev/null
+    checkResults 42 1 $STATUS
+    rm -rf batch-out input-h.txt
+
+    # A pattern sees the line as earlier col and field commands left it.
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 40: ./chop cols 1 21 match '^#F' input-c.txt output.txt > stdout.txt 2> stderr.txt"
+    ./chop cols 1 21 match '^#F' input-c.txt output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 40 0 $STATUS
+
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 41: ./chop -d , fields 1 2 nomatch '^5' input-g.txt output.txt > stdout.txt 2> stderr.txt"
+    ./chop -d , fields 1 2 nomatch '^5' input-g.txt output.txt > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 41 0 $STATUS
+
+    # A missing pattern prints the full usage.
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 43: ./chop line 1 match > stdout.txt 2> stderr.txt"
+    ./chop line 1 match > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 43 1 $STATUS
+
+    rm -f output.txt stdout.txt stderr.txt
+    echo "Test 44: ./chop --help > stdout.txt 2> stderr.txt"
+    ./chop --help > stdout.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 44 0 $STATUS
 else
     echo "**** Your program couldn't be tested since it didn't compile successfully."
     FAIL=1
@@ -3,60 +3,252 @@
  * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
  * read and write from and to files
  */
+#define _POSIX_C_SOURCE 200809L
+
 #include "text.h"
 
+#include "scan.h"
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * size of each block read from a stream that can't be mapped
+ */
+#define BLOCK_SIZE 65536
+
+/**
+ * initial capacity of the line index
+ */
+#define LINE_CAPACITY 1024
+
+/**
+ * newline positions found per scan while indexing
+ */
+#define SCAN_BATCH 1024
 
 /**
- * @brief read the file specified by the file pointer
+ * @brief print an error and exit
+ * @param message to print
+ */
+static void
+fail(const char* message)
+{
+    fprintf(stderr, "%s\n", message);
+    exit(1);
+}
+
+/**
+ * @brief read a whole stream into a malloc'd buffer, a block at a time
  * @param fp the file pointer
+ * @param size receives the number of bytes read
+ * @return the buffer
  */
-void
-readFile(FILE* fp)
+static char*
+read_blocks(FILE* fp, size_t* size)
 {
-    if (fp == NULL) {
-        return;
+    size_t capacity = BLOCK_SIZE;
+    size_t used = 0;
+    char* buffer = malloc(capacity);
+
+    while (buffer != NULL) {
+        if (used == capacity) {
+            capacity *= 2;
+            char* t_buffer = realloc(buffer, capacity);
+            if (t_buffer == NULL) {
+                free(buffer);
+                buffer = NULL;
+                break;
+            }
+            buffer = t_buffer;
+        }
+
+        size_t count = fread(buffer + used, 1, capacity - used, fp);
+        used += count;
+
+        if (count == 0) {
+            break;
+        }
     }
 
-    int rowCount = 0;
+    if (buffer == NULL || ferror(fp)) {
+        fail("Can't read input");
+    }
+    *size = used;
+    return buffer;
+}
 
-    while (true) {
-        if (rowCount > MAX_ROWS) {
-            fprintf(stderr, "Too many lines\n");
-            exit(1);
+/**
+ * @brief add a line to the text's line index
+ * @param text being indexed
+ * @param offset of the line in the buffer
+ * @param length of the line without its newline
+ */
+static void
+text_add_line(Text* text, size_t offset, size_t length)
+{
+    if (text->line_count == text->line_capacity) {
+        text->line_capacity *= 2;
+        Line* lines =
+          realloc(text->lines, text->line_capacity * sizeof(Line));
+        if (lines == NULL) {
+            fail("Too many lines");
         }
+        text->lines = lines;
+    }
+    Line line = {.offset = offset, .length = length};
+    text->lines[text->line_count] = line;
+    text->line_count += 1;
+}
+
+/**
+ * @brief build the line index of the text buffer. a last line without a
+ * newline still counts as a line
+ * @param text being indexed
+ */
+static void
+text_index(Text* text)
+{
+    size_t positions[SCAN_BATCH];
+    const char* data = text->buffer;
+    const char* end = text->buffer + text->size;
+    size_t offset = 0;
 
-        int colCount = 0;
-        char c;
+    while (data < end) {
+        const char* next;
+        const size_t found =
+          scan_positions(data, end, '\n', positions, SCAN_BATCH, &next);
+        const size_t base = data - text->buffer;
 
-        if ((c = fgetc(fp)) == EOF) {
-            break;
-        } else {
-            ungetc(c, fp);
+        for (size_t i = 0; i < found; i++) {
+            const size_t newline = base + positions[i];
+
+            text_add_line(text, offset, newline - offset);
+            offset = newline + 1;
         }
+        data = next;
+    }
 
-        while ((c = fgetc(fp)) != '\n') {
-            if (colCount >= MAX_COLS - 1) {
-                fprintf(stderr, "Line too long\n");
-                exit(1);
-            }
-            FILE_STRING[rowCount][colCount] = c;
-            colCount++;
+    if (offset < text->size) {
+        text_add_line(text, offset, text->size - offset);
+    }
+}
+
+/**
+ * @brief read or map the file specified by the file pointer without building
+ * the line index. regular files are mapped copy on write, anything else is
+ * read in large blocks
+ * @param fp the file pointer
+ * @return the text, with an empty line index
+ */
+Text
+text_open(FILE* fp)
+{
+    Text text = {.buffer = NULL,
+                 .size = 0,
+                 .mapped = false,
+                 .lines = malloc(LINE_CAPACITY * sizeof(Line)),
+                 .line_count = 0,
+                 .line_capacity = LINE_CAPACITY};
+
+    if (fp == NULL) {
+        return text;
+    }
+
+    struct stat st;
+    int fd = fileno(fp);
+
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        // Private mapping, so edits in place never reach the input file.
+        void* map = mmap(NULL,
+                         st.st_size,
+                         PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE,
+                         fd,
+                         0);
+        if (map != MAP_FAILED) {
+            text.buffer = map;
+            text.size = st.st_size;
+            text.mapped = true;
         }
-        rowCount++;
     }
-    ROW_COUNT = rowCount;
+
+    if (!text.mapped) {
+        text.buffer = read_blocks(fp, &text.size);
+    }
+    return text;
+}
+
+/**
+ * @brief read the file specified by the file pointer. regular files are
+ * mapped copy on write, anything else is read in large blocks
+ * @param fp the file pointer
+ * @return the text with its line index
+ */
+Text
+readFile(FILE* fp)
+{
+    Text text = text_open(fp);
+
+    text_index(&text);
+    return text;
 }
 
 /**
  * @brief write the file specified by the a file pointer
+ * @param text being written
  * @param fp the file pointer
  */
 void
-writeFile(FILE* fp)
+writeFile(Text* text, FILE* fp)
+{
+    for (long i = 0; i < text->line_count; i++) {
+        Line line = text->lines[i];
+
+        fwrite(text->buffer + line.offset, 1, line.length, fp);
+        fputc('\n', fp);
+    }
+}
+
+/**
+ * @brief copy a mapped text buffer into memory, so the file it was mapped from
+ * can be truncated or overwritten while the text is still in use
+ * @param text being copied
+ */
+void
+text_unmap(Text* text)
+{
+    if (!text->mapped) {
+        return;
+    }
+    char* buffer = malloc(text->size);
+    if (buffer == NULL) {
+        fail("Can't read input");
+    }
+    memcpy(buffer, text->buffer, text->size);
+    munmap(text->buffer, text->size);
+
+    text->buffer = buffer;
+    text->mapped = false;
+}
+
+/**
+ * @brief release the text buffer and line index
+ * @param text being destroyed
+ */
+void
+text_destroy(Text* text)
 {
-    for (int i = 0; i < ROW_COUNT; i++) {
-        fprintf(fp, "%s\n", FILE_STRING[i]);
+    if (text->mapped) {
+        munmap(text->buffer, text->size);
+    } else {
+        free(text->buffer);
     }
+    free(text->lines);
+
+    text->buffer = NULL;
+    text->lines = NULL;
+    text->line_count = 0;
 }
@@ -13,37 +13,67 @@
 #include <string.h>
 
 /**
- * max rows of a file
+ * one line of the text, as a span of the text buffer without its newline
  */
-#define MAX_ROWS 10000
+typedef struct {
+    size_t offset;
+    size_t length;
+} Line;
 
 /**
- * max cols of a file
+ * the text being edited: the input file, mapped or read in large blocks, and
+ * an index of where each line starts and how long it is
  */
-#define MAX_COLS 101
+typedef struct {
+    char* buffer;
+    size_t size;
+    bool mapped;
 
-/**
- * file string of data
- */
-char FILE_STRING[MAX_ROWS][MAX_COLS];
+    Line* lines;
+    long line_count;
+    long line_capacity;
+} Text;
 
 /**
- * row count to keep track of rows
+ * @brief read or map the file specified by the file pointer without building
+ * the line index. regular files are mapped copy on write, anything else is
+ * read in large blocks
+ * @param fp the file pointer
+ * @return the text, with an empty line index
  */
-int ROW_COUNT;
+Text
+text_open(FILE* fp);
 
 /**
- * @brief read the file specified by the file pointer
+ * @brief read the file specified by the file pointer. regular files are
+ * mapped copy on write, anything else is read in large blocks
  * @param fp the file pointer
+ * @return the text with its line index
  */
-void
+Text
 readFile(FILE* fp);
 
 /**
  * @brief write the file specified by the a file pointer
+ * @param text being written
  * @param fp the file pointer
  */
 void
-writeFile(FILE* fp);
+writeFile(Text* text, FILE* fp);
+
+/**
+ * @brief copy a mapped text buffer into memory, so the file it was mapped from
+ * can be truncated or overwritten while the text is still in use
+ * @param text being copied
+ */
+void
+text_unmap(Text* text);
+
+/**
+ * @brief release the text buffer and line index
+ * @param text being destroyed
+ */
+void
+text_destroy(Text* text);
 
 #endif
@@ -1,10 +1,34 @@
 /**
  * @file vector.c
  * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
- * stores the command line arguments into a vector
+ * growable array of fixed size elements, such as the command line arguments
  */
 #include "vector.h"
 
+/**
+ * initial number of elements a vector has room for
+ */
+#define VECTOR_CAPACITY 5
+
+/**
+ * @brief resize the storage of a vector, exiting if there is no memory
+ * @param vec to resize
+ * @param capacity number of elements
+ */
+static void
+vector_resize(Vector* vec, int capacity)
+{
+    capacity = capacity > 0 ? capacity : 1;
+    char* data = realloc(vec->data, (size_t) vec->element_size * capacity);
+
+    if (data == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    vec->data = data;
+    vec->capacity = capacity;
+}
+
 /**
  * @brief create a vector
  * @param element size to create vector from
@@ -13,14 +37,11 @@
 Vector
 vector_create(int element_size)
 {
-    const int initial_capacity = 5;
-    const int size = 0;
-
     Vector vec = {.data = NULL,
-                  .size = size,
-                  .capacity = initial_capacity,
+                  .size = 0,
+                  .capacity = 0,
                   .element_size = element_size};
-    vec.data = malloc(sizeof(void*) * element_size * initial_capacity);
+    vector_resize(&vec, VECTOR_CAPACITY);
     return vec;
 }
 
@@ -32,40 +53,53 @@ void
 vector_destroy(Vector* vec)
 {
     free(vec->data);
-    vec = NULL;
+    vec->data = NULL;
+    vec->size = 0;
+    vec->capacity = 0;
 }
 
 /**
- * @brief shrink or grow the vector
- * @param vec to shrink or grow
- * @param shrink if the vector should be shrinked or not
- * @return the pointer to the new adjusted vector
+ * @brief get an element of a vector
+ * @param vec to get the element from
+ * @param idx of the element
+ * @return pointer to the element, valid until the vector is next changed
  */
-Vector*
-vector_grow(Vector* vec)
+void*
+vector_get(const Vector* vec, size_t idx)
 {
-    if (vec->size >= vec->capacity) {
-        vec->capacity *= 2;
-    } else {
-        return vec;
-    }
-
-    void** new_data =
-      realloc(vec->data, sizeof(void*) * vec->element_size * vec->capacity);
+    return vec->data + (size_t) vec->element_size * idx;
+}
 
-    if (new_data == NULL) {
-        free(vec->data);
-        return NULL;
-    } else {
-        vec->data = new_data;
-        return vec;
+/**
+ * @brief make room for at least capacity elements
+ * @param vec to make room in
+ * @param capacity number of elements
+ * @return the vector
+ */
+Vector*
+vector_reserve(Vector* vec, int capacity)
+{
+    if (capacity > vec->capacity) {
+        vector_resize(vec, capacity);
     }
+    return vec;
 }
 
-void*
-vector_get(const Vector* vec, size_t idx)
+/**
+ * @brief make room for count more elements, at least doubling the capacity
+ * so pushes take constant time on average
+ * @param vec to grow
+ * @param count number of elements being added
+ */
+static void
+vector_grow(Vector* vec, int count)
 {
-    return vec->data + (vec->element_size * idx);
+    if (vec->size + count > vec->capacity) {
+        const int doubled = vec->capacity * 2;
+        vector_reserve(vec,
+                       vec->size + count > doubled ? vec->size + count
+                                                   : doubled);
+    }
 }
 
 /**
@@ -75,15 +109,79 @@ vector_get(const Vector* vec, size_t idx)
  * @return new pointer to the pushed argument
  */
 Vector*
-vector_push(Vector* vec, void* arg)
+vector_push(Vector* vec, const void* arg)
 {
-    vec = vector_grow(vec);
-    memcpy(vector_get(vec, vec->size), arg, vec->element_size);
-    vec->size += 1;
+    return vector_append(vec, arg, 1);
+}
+
+/**
+ * @brief append elements to a vector with one copy
+ * @param vec to append to
+ * @param elements to append, back to back
+ * @param count number of elements
+ * @return the vector
+ */
+Vector*
+vector_append(Vector* vec, const void* elements, int count)
+{
+    vector_grow(vec, count);
+    memcpy(vector_get(vec, vec->size),
+           elements,
+           (size_t) vec->element_size * count);
+    vec->size += count;
+
+    return vec;
+}
+
+/**
+ * @brief insert elements before the element at idx, moving the rest up
+ * @param vec to insert into
+ * @param idx of the first inserted element, at most the size
+ * @param elements to insert, back to back
+ * @param count number of elements
+ * @return the vector
+ */
+Vector*
+vector_insert(Vector* vec, int idx, const void* elements, int count)
+{
+    vector_grow(vec, count);
+    memmove(vector_get(vec, idx + count),
+            vector_get(vec, idx),
+            (size_t) vec->element_size * (vec->size - idx));
+    memcpy(vector_get(vec, idx), elements, (size_t) vec->element_size * count);
+    vec->size += count;
 
     return vec;
 }
 
+/**
+ * @brief erase elements, moving the rest down
+ * @param vec to erase from
+ * @param idx of the first erased element
+ * @param count number of elements, cut short at the end of the vector
+ */
+void
+vector_erase(Vector* vec, int idx, int count)
+{
+    count = count < vec->size - idx ? count : vec->size - idx;
+    memmove(vector_get(vec, idx),
+            vector_get(vec, idx + count),
+            (size_t) vec->element_size * (vec->size - idx - count));
+    vec->size -= count;
+}
+
+/**
+ * @brief give back the room for elements past the size
+ * @param vec to shrink
+ */
+void
+vector_shrink(Vector* vec)
+{
+    if (vec->size < vec->capacity) {
+        vector_resize(vec, vec->size);
+    }
+}
+
 /**
  * @brief vector_pop an element off a vector
  * @param vec to vector_pop off an argument from
@@ -4,7 +4,7 @@
 /**
  * @file vector.h
  * @author Mike Babb (mbabb),  Sanjana Cheerla (scheerl)
- * stores the command line arguments into a vector
+ * growable array of fixed size elements, such as the command line arguments
  */
 #include <math.h>
 #include <stdbool.h>
@@ -13,11 +13,12 @@
 #include <string.h>
 
 /**
- * vector consisting of arguments, size, capacity, and the size of the elements
+ * vector of size elements of element_size bytes each, stored back to back in
+ * room for capacity of them
  */
 typedef struct
 {
-    void** data;
+    char* data;
     int size;
     int capacity;
     int element_size;
@@ -39,9 +40,24 @@ vector_create(int element_size);
 void
 vector_destroy(Vector* vec);
 
+/**
+ * @brief get an element of a vector
+ * @param vec to get the element from
+ * @param idx of the element
+ * @return pointer to the element, valid until the vector is next changed
+ */
 void*
 vector_get(const Vector* vec, size_t idx);
 
+/**
+ * @brief make room for at least capacity elements
+ * @param vec to make room in
+ * @param capacity number of elements
+ * @return the vector
+ */
+Vector*
+vector_reserve(Vector* vec, int capacity);
+
 /**
  * @brief push an argument onto a vector
  * @param vec to push arg to
@@ -49,7 +65,44 @@ vector_get(const Vector* vec, size_t idx);
  * @return new pointer to the pushed argument
  */
 Vector*
-vector_push(Vector* vec, void* arg);
+vector_push(Vector* vec, const void* arg);
+
+/**
+ * @brief append elements to a vector with one copy
+ * @param vec to append to
+ * @param elements to append, back to back
+ * @param count number of elements
+ * @return the vector
+ */
+Vector*
+vector_append(Vector* vec, const void* elements, int count);
+
+/**
+ * @brief insert elements before the element at idx, moving the rest up
+ * @param vec to insert into
+ * @param idx of the first inserted element, at most the size
+ * @param elements to insert, back to back
+ * @param count number of elements
+ * @return the vector
+ */
+Vector*
+vector_insert(Vector* vec, int idx, const void* elements, int count);
+
+/**
+ * @brief erase elements, moving the rest down
+ * @param vec to erase from
+ * @param idx of the first erased element
+ * @param count number of elements, cut short at the end of the vector
+ */
+void
+vector_erase(Vector* vec, int idx, int count);
+
+/**
+ * @brief give back the room for elements past the size
+ * @param vec to shrink
+ */
+void
+vector_shrink(Vector* vec);
 
 /**
  * @brief pop an element off a vector
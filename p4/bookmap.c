@@ -0,0 +1,202 @@
+/**
+ * @file bookmap.c
+ * @author Mike Babb
+ * @author Sanjana Cheerla
+ * @brief hash index from book id to book, so books can be found and
+ * duplicates rejected without scanning the catalog
+ */
+
+#include "bookmap.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * initial number of slots, a power of two
+ */
+#define MAP_CAPACITY 16
+
+/**
+ * 2^32 divided by the golden ratio, spreads consecutive ids over the table
+ */
+#define MAP_MULTIPLIER 2654435769u
+
+/**
+ * @brief the slot an id is looked for first
+ * @param map being probed
+ * @param id to hash
+ * @return index of the slot
+ */
+static int
+home_slot(const BookMap* map, int id)
+{
+    return (int) (((uint32_t) id * MAP_MULTIPLIER) & (map->capacity - 1));
+}
+
+/**
+ * @brief find the slot holding an id, or the empty slot where it would go
+ * @param map being probed
+ * @param id to look for
+ * @return index of the slot
+ */
+static int
+find_slot(const BookMap* map, int id)
+{
+    int ix = home_slot(map, id);
+
+    while (map->slots[ix].book != NULL && map->slots[ix].id != id) {
+        ix = (ix + 1) & (map->capacity - 1);
+    }
+    return ix;
+}
+
+/**
+ * @brief allocate empty slots, exiting if there is no memory
+ * @param capacity number of slots
+ * @return the slots
+ */
+static BookSlot*
+make_slots(int capacity)
+{
+    BookSlot* slots = calloc(capacity, sizeof(BookSlot));
+
+    if (slots == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return slots;
+}
+
+/**
+ * @brief double the number of slots and put every book back
+ * @param map to grow
+ */
+static void
+grow(BookMap* map)
+{
+    BookSlot* old = map->slots;
+    const int old_capacity = map->capacity;
+
+    map->capacity *= 2;
+    map->slots = make_slots(map->capacity);
+
+    for (int i = 0; i < old_capacity; i++) {
+        if (old[i].book != NULL) {
+            map->slots[find_slot(map, old[i].id)] = old[i];
+        }
+    }
+    free(old);
+}
+
+/**
+ * @brief create an empty map
+ * @return created map
+ */
+BookMap
+book_map_create(void)
+{
+    BookMap map = {.slots = make_slots(MAP_CAPACITY),
+                   .size = 0,
+                   .capacity = MAP_CAPACITY};
+    return map;
+}
+
+/**
+ * @brief free the map, but not the books in it
+ * @param map to free
+ */
+void
+book_map_destroy(BookMap* map)
+{
+    free(map->slots);
+    map->slots = NULL;
+    map->size = 0;
+    map->capacity = 0;
+}
+
+/**
+ * @brief find a book by id
+ * @param map to search
+ * @param id of the book
+ * @return the book, or NULL if there is no book with that id
+ */
+struct Book*
+book_map_get(const BookMap* map, int id)
+{
+    return map->slots[find_slot(map, id)].book;
+}
+
+/**
+ * @brief find the slot of a book by id, to read or set its position
+ * @param map to search
+ * @param id of the book
+ * @return the slot, or NULL if there is no book with that id
+ */
+BookSlot*
+book_map_find(const BookMap* map, int id)
+{
+    BookSlot* slot = &map->slots[find_slot(map, id)];
+    return slot->book != NULL ? slot : NULL;
+}
+
+/**
+ * @brief add a book under its id, unless there is already a book with it.
+ * the position of its slot starts at 0
+ * @param map to add to
+ * @param id of the book
+ * @param book to add
+ * @return true if the book was added, false if the id was taken
+ */
+bool
+book_map_put(BookMap* map, int id, struct Book* book)
+{
+    if ((map->size + 1) * 2 > map->capacity) {
+        grow(map);
+    }
+
+    const int ix = find_slot(map, id);
+    if (map->slots[ix].book != NULL) {
+        return false;
+    }
+
+    map->slots[ix].id = id;
+    map->slots[ix].position = 0;
+    map->slots[ix].book = book;
+    map->size += 1;
+    return true;
+}
+
+/**
+ * @brief remove the book with an id. the books probed past it are moved back
+ * into the gap, so lookups never need markers for removed books
+ * @param map to remove from
+ * @param id of the book
+ * @return the removed book, or NULL if there is no book with that id
+ */
+struct Book*
+book_map_remove(BookMap* map, int id)
+{
+    const int mask = map->capacity - 1;
+    int gap = find_slot(map, id);
+    struct Book* removed = map->slots[gap].book;
+
+    if (removed == NULL) {
+        return NULL;
+    }
+
+    for (int ix = (gap + 1) & mask; map->slots[ix].book != NULL;
+         ix = (ix + 1) & mask) {
+        // A book can fill the gap if the gap lies between its home slot and
+        // where it is now.
+        const int home = home_slot(map, map->slots[ix].id);
+        if (((ix - home) & mask) >= ((ix - gap) & mask)) {
+            map->slots[gap] = map->slots[ix];
+            gap = ix;
+        }
+    }
+
+    map->slots[gap].book = NULL;
+    map->size -= 1;
+    return removed;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file bookmap.h
+ * @author Mike Babb
+ * @author Sanjana Cheerla
+ * @brief hash index from book id to book, so books can be found and
+ * duplicates rejected without scanning the catalog
+ */
+
+#ifndef bookmap_h
+#define bookmap_h
+
+#include <stdbool.h>
+
+/**
+ * forward declaration of the book struct in catalog.h
+ */
+struct Book;
+
+/**
+ * slot of the index, empty when book is NULL. the id is kept next to the
+ * book so probing doesn't have to follow the pointer. position is left to
+ * the owner of the map, the reading list keeps the place of the book in its
+ * list there
+ */
+typedef struct {
+    int id;
+    int position;
+    struct Book* book;
+} BookSlot;
+
+/**
+ * open addressing hash table of books by id, probed linearly. capacity is
+ * always a power of two and kept at least twice the size
+ */
+typedef struct {
+    BookSlot* slots;
+    int size;
+    int capacity;
+} BookMap;
+
+/**
+ * @brief create an empty map
+ * @return created map
+ */
+BookMap
+book_map_create(void);
+
+/**
+ * @brief free the map, but not the books in it
+ * @param map to free
+ */
+void
+book_map_destroy(BookMap* map);
+
+/**
+ * @brief find a book by id
+ * @param map to search
+ * @param id of the book
+ * @return the book, or NULL if there is no book with that id
+ */
+struct Book*
+book_map_get(const BookMap* map, int id);
+
+/**
+ * @brief find the slot of a book by id, to read or set its position
+ * @param map to search
+ * @param id of the book
+ * @return the slot, or NULL if there is no book with that id
+ */
+BookSlot*
+book_map_find(const BookMap* map, int id);
+
+/**
+ * @brief add a book under its id, unless there is already a book with it.
+ * the position of its slot starts at 0
+ * @param map to add to
+ * @param id of the book
+ * @param book to add
+ * @return true if the book was added, false if the id was taken
+ */
+bool
+book_map_put(BookMap* map, int id, struct Book* book);
+
+/**
+ * @brief remove the book with an id
+ * @param map to remove from
+ * @param id of the book
+ * @return the removed book, or NULL if there is no book with that id
+ */
+struct Book*
+book_map_remove(BookMap* map, int id);
+
+#endif /* bookmap_h */
@@ -8,24 +8,11 @@
 
 #include "catalog.h"
 
+#include "loader.h"
+#include "snapshot.h"
 #include "vector/vector.h"
 
-#define BOOK_VAL 5
-
-/**
- * 2nd field of book
- */
-#define AUTHOR 2
-
-/**
- * 3rd field of book
- */
-#define LEVEL 3
-
-/**
- * 4th field of book
- */
-#define WORDS 4
+#include <math.h>
 
 /**
  * @brief create a catalog
@@ -36,6 +23,14 @@ makeCatalog()
 {
     Catalog* catalog = (Catalog*) malloc(sizeof(Catalog));
     catalog->books = vector_create(sizeof(Book*));
+    catalog->removed = 0;
+    catalog->ids = book_map_create();
+    catalog->by_id = NULL;
+    catalog->by_level = NULL;
+    catalog->subjects = subject_index_create(NULL, 0);
+    catalog->indexed = false;
+    catalog->snapshot = NULL;
+    catalog->snapshot_size = 0;
     return catalog;
 }
 
@@ -46,12 +41,21 @@ makeCatalog()
 void
 freeCatalog(Catalog* cat)
 {
+    if (cat->snapshot != NULL) {
+        snapshot_close(cat);
+        return;
+    }
+
     for (int i = 0; i < cat->books.size; i++) {
         Book* book = *(Book**) vector_get(&cat->books, i);
         free(book->subject);
         free(book);
     }
     vector_destroy(&cat->books);
+    book_map_destroy(&cat->ids);
+    free(cat->by_id);
+    free(cat->by_level);
+    subject_index_destroy(&cat->subjects);
     free(cat);
 }
 
@@ -82,7 +86,10 @@ int_compare(int val1, int val2)
 int
 double_compare(double val1, double val2)
 {
-    if (val1 < val2) {
+    // Levels that aren't numbers go last, so sorting by level stays ordered.
+    if (isnan(val1) || isnan(val2)) {
+        return int_compare(isnan(val1), isnan(val2));
+    } else if (val1 < val2) {
         return -1;
     } else if (val1 > val2) {
         return 1;
@@ -138,14 +145,7 @@ compareByLevel(const void* p1, const void* p2)
 Book*
 get_book_by_id(Catalog* cat, int id)
 {
-    for (int i = 0; i < cat->books.size; i++) {
-        Book* t_book = *(Book**) vector_get(&cat->books, i);
-
-        if (t_book->id == id) {
-            return t_book;
-        }
-    }
-    return NULL;
+    return book_map_get(&cat->ids, id);
 }
 
 char*
@@ -187,133 +187,109 @@ strsplit2(char* line, char* delimiter)
     return comps;
 }
 
-char*
-clamp_str(char* src, int max_len, char* clamp_value)
+/**
+ * @brief free the books of a vector from one index on
+ * @param books to free
+ * @param from index of the first book to free
+ */
+static void
+free_books(Vector* books, int from)
 {
-    int len = strlen(src);
-    int ix = max_len - strlen(clamp_value);
-
-    if (len > max_len && ix > 0 && ix < len) {
-        strcpy(&src[ix], clamp_value);
+    for (int i = from; i < books->size; i++) {
+        Book* book = *(Book**) vector_get(books, i);
+        free(book->subject);
+        free(book);
     }
-
-    return src;
 }
 
-Book*
-book_create(char* line)
+/**
+ * @brief add the books read from a list to the catalog, in order. a
+ * duplicate id before the first invalid line is reported rather than the
+ * invalid line, as the list is read in order
+ * @param cat to add books to
+ * @param list read by load_lists
+ * @return true if every book was added and the list was valid, false after
+ * printing why not. the books not added are freed either way
+ */
+static bool
+merge_books(Catalog* cat, BookList* list)
 {
-    Book* book = (Book*) malloc(sizeof(Book));
-    Vector line_comps = strsplit2(line, "\t");
-
-    if (line_comps.size < BOOK_VAL) {
-        goto fail;
-    } else {
-        char* end;
-
-        char* id_str = *(char**) vector_get(&line_comps, 0);
-
-        char* title = *(char**) vector_get(&line_comps, 1);
-        char* author = *(char**) vector_get(&line_comps, AUTHOR);
-
-        char* level_str = *(char**) vector_get(&line_comps, LEVEL);
-        char* words_str = *(char**) vector_get(&line_comps, WORDS);
-
-        char* subject = line_comps.size == BOOK_VAL + 1
-                          ? *(char**) vector_get(&line_comps, BOOK_VAL)
-                          : NULL;
-
-        int id = (int) strtod(id_str, &end);
-        if (end == id_str) {
-            goto fail;
-        }
+    if (list->status == LOAD_CANT_OPEN) {
+        fprintf(stderr, "Can't open file: %s\n", list->filename);
+        return false;
+    }
 
-        double level = strtod(level_str, &end);
-        if (end == level_str) {
-            goto fail;
-        }
+    for (int i = 0; i < list->books.size; i++) {
+        Book* book = *(Book**) vector_get(&list->books, i);
 
-        int words = (int) strtod(words_str, &end);
-        if (end == words_str) {
-            goto fail;
+        if (!book_map_put(&cat->ids, book->id, book)) {
+            fprintf(stderr, "Duplicate book id: %d\n", book->id);
+            free_books(&list->books, i);
+            return false;
+        } else {
+            vector_push(&cat->books, &book);
+            cat->indexed = false;
         }
-
-        clamp_str(title, TITLE_LENGTH, DOTS);
-        clamp_str(author, AUTHOR_LENGTH, DOTS);
-
-        book->id = id;
-
-        strcpy(book->title, title);
-        strcpy(book->author, author);
-
-        book->level = level;
-        book->words = words;
-
-        book->subject = strdup2(subject);
-
-        goto success;
-    }
-fail:
-    free(book);
-    for (int i = 0; i < line_comps.size; i++) {
-        free(*(char**) vector_get(&line_comps, i));
     }
-    vector_destroy(&line_comps);
-    return NULL;
-success:
-    for (int i = 0; i < line_comps.size; i++) {
-        free(*(char**) vector_get(&line_comps, i));
+
+    if (list->status == LOAD_INVALID) {
+        fprintf(stderr, "Invalid book list: %s\n", list->filename);
+        return false;
     }
-    vector_destroy(&line_comps);
-    return book;
+    return true;
 }
 
 /**
- * @brief read books into catalog
+ * @brief read books into catalog from several files. the files are read at
+ * the same time and then added in order, so the first problem reported is
+ * the one reading them one at a time would find
  * @param cat to read books into
- * @param filename of book information
+ * @param filenames of book information
+ * @param count of files
  */
 void
-readCatalog(Catalog* cat, char const* filename)
+readCatalogs(Catalog* cat, char const* const filenames[], int count)
 {
-    FILE* fp = fopen(filename, "r");
+    BookList* lists = malloc((count + 1) * sizeof(BookList));
 
-    if (fp == NULL) {
-        fprintf(stderr, "Can't open file: %s\n", filename);
-        freeCatalog(cat);
+    if (lists == NULL) {
+        fprintf(stderr, "Out of memory\n");
         exit(1);
     }
+    for (int i = 0; i < count; i++) {
+        lists[i].filename = filenames[i];
+    }
 
-    while (true) {
-        char* line = readLine(fp);
-
-        if (line == NULL) {
-            break;
-        }
-
-        Book* book = book_create(line);
-        free(line);
+    load_lists(lists, count);
 
-        if (book == NULL) {
-            fprintf(stderr, "Invalid book list: %s\n", filename);
-            goto fail;
-        }
+    int merged = 0;
+    while (merged < count && merge_books(cat, &lists[merged])) {
+        vector_destroy(&lists[merged].books);
+        merged += 1;
+    }
 
-        if (get_book_by_id(cat, book->id) != NULL) {
-            fprintf(stderr, "Duplicate book id: %d\n", book->id);
-            goto fail;
-        } else {
-            vector_push(&cat->books, &book);
+    if (merged < count) {
+        vector_destroy(&lists[merged].books);
+        for (int i = merged + 1; i < count; i++) {
+            free_books(&lists[i].books, 0);
+            vector_destroy(&lists[i].books);
         }
+        free(lists);
+        freeCatalog(cat);
+        exit(1);
     }
-    goto success;
-
-fail:
-    fclose(fp);
-    freeCatalog(cat);
-    exit(1);
-success:
-    fclose(fp);
+    free(lists);
+}
+
+/**
+ * @brief read books into catalog
+ * @param cat to read books into
+ * @param filename of book information
+ */
+void
+readCatalog(Catalog* cat, char const* filename)
+{
+    readCatalogs(cat, &filename, 1);
 }
 
 /**
@@ -322,14 +298,45 @@ success:
 typedef int (*Comparator)(const void*, const void*);
 
 /**
- * @brief sort the vatalog by comparator
- * @param cat to sort
+ * @brief copy the books of the catalog and sort them by comparator
+ * @param cat to copy the books of
  * @param comp comparator
+ * @return the sorted books
+ */
+static Book**
+sorted_books(Catalog* cat, Comparator comp)
+{
+    // One extra so an empty catalog still gets an array.
+    Book** books = malloc((cat->books.size + 1) * sizeof(Book*));
+
+    if (books == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    memcpy(books, cat->books.data, cat->books.size * sizeof(Book*));
+    qsort(books, cat->books.size, sizeof(Book*), comp);
+    return books;
+}
+
+/**
+ * @brief sort the books of the catalog by id and by level and index their
+ * subjects, if they have changed since they were last indexed
+ * @param cat catalog to index
  */
 void
-sort_catalog(Catalog* cat, Comparator comp)
+indexCatalog(Catalog* cat)
 {
-    qsort(cat->books.data, cat->books.size, cat->books.element_size, comp);
+    if (cat->indexed) {
+        return;
+    }
+
+    free(cat->by_id);
+    free(cat->by_level);
+    subject_index_destroy(&cat->subjects);
+    cat->by_id = sorted_books(cat, compareByID);
+    cat->by_level = sorted_books(cat, compareByLevel);
+    cat->subjects = subject_index_create(cat->by_id, cat->books.size);
+    cat->indexed = true;
 }
 
 /**
@@ -344,6 +351,54 @@ list_all_predicate(Book const* book, void const* data)
     return true;
 }
 
+/**
+ * @brief print the selected books of an array, or that there are none
+ * @param books to select from
+ * @param count of books
+ * @param test function
+ * @param data passed to test
+ */
+static void
+list_books(Book* const* books,
+           int count,
+           bool (*test)(Book const* book, void const* data),
+           void const* data)
+{
+    const char* header = "   ID                                  Title         "
+                         "      Author Level   Words\n";
+
+    const char* fmt_string = "%5d %38s %20s %5.1lf %7d\n";
+
+    int print_count = 0;
+
+    for (int i = 0; i < count; i++) {
+        bool to_print = test(books[i], data);
+
+        print_count = to_print ? print_count + 1 : print_count;
+    }
+
+    if (print_count == 0) {
+        printf("No matching books\n");
+    } else {
+        printf("%s", header);
+
+        for (int i = 0; i < count; i++) {
+            Book* book = books[i];
+
+            bool to_print = test(book, data);
+
+            if (to_print) {
+                printf(fmt_string,
+                       book->id,
+                       book->title,
+                       book->author,
+                       book->level,
+                       book->words);
+            }
+        }
+    }
+}
+
 /**
  * @brief list all books in the catalog
  * @param cat catalog of books to list
@@ -351,61 +406,67 @@ list_all_predicate(Book const* book, void const* data)
 void
 listAll(Catalog* cat)
 {
-    sort_catalog(cat, compareByID);
-    listCatalog(cat, list_all_predicate, NULL);
+    indexCatalog(cat);
+    list_books(cat->by_id, cat->books.size, list_all_predicate, NULL);
 }
 
 /**
- * @brief list level predicate to list all values
- * @param book to list all
- * @param data of book
- * @return true if book level is between min and max, false otherwise
+ * @brief list the books whose subject contains some text
+ * @param cat catalog of books
+ * @param subject text to look for
  */
-bool
-list_subject_predicate(Book const* book, void const* data)
-{
-    char* subject = *(char**) data;
-
-    char* book_subject = strstr(book->subject, subject);
-
-    return book_subject != NULL;
-}
-
 void
 listSubject(Catalog* cat, char const* subject)
 {
-    Vector vec = vector_create(sizeof(char*));
-    vector_push(&vec, &subject);
+    indexCatalog(cat);
+
+    Book** matches = malloc((cat->books.size + 1) * sizeof(Book*));
+    if (matches == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
 
-    sort_catalog(cat, compareByID);
-    listCatalog(cat, list_subject_predicate, vec.data);
+    const int count = subject_index_find(
+      &cat->subjects, cat->by_id, cat->books.size, subject, matches);
+    list_books(matches, count, list_all_predicate, NULL);
 
-    vector_destroy(&vec);
+    free(matches);
 }
 
 /**
- * @brief list level predicate to list all values
- * @param book to list all
- * @param data of book
- * @return true if book level is between min and max, false otherwise
+ * @brief find the first book of those sorted by level whose level is past a
+ * bound
+ * @param books sorted by level
+ * @param count of books
+ * @param bound level to compare with
+ * @param inclusive true to stop at a level equal to bound, false to go past it
+ * and stop at the levels that aren't numbers, sorted last
+ * @return index of the book, or count if there is none
  */
-bool
-list_level_predicate(Book const* book, void const* data)
+static int
+level_bound(Book* const* books, int count, double bound, bool inclusive)
 {
-    double min = *(double*) (data + 0);
-    double max = *(double*) (data + 1 * sizeof(double*));
+    int lo = 0;
+    int hi = count;
 
-    double level = book->level;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        const double level = books[mid]->level;
 
-    if (level < min || level > max) {
-        return false;
-    } else {
-        return true;
+        if (inclusive ? level < bound : !(level > bound || isnan(level))) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
     }
+    return lo;
 }
 
 /**
- * @brief list levels of books
+ * @brief list levels of books. the books from min to max are next to each
+ * other when sorted by level, so only their bounds are searched for. books
+ * whose level isn't a number fail no comparison with min or max, so they
+ * are listed for every range, after the others
  * @param cat catalog
  * @param min of levels
  * @param max of levels
@@ -413,14 +474,52 @@ list_level_predicate(Book const* book, void const* data)
 void
 listLevel(Catalog* cat, double min, double max)
 {
-    Vector vec = vector_create(sizeof(double));
-    vector_push(&vec, &min);
-    vector_push(&vec, &max);
+    indexCatalog(cat);
+
+    const int count = cat->books.size;
+    const int first = level_bound(cat->by_level, count, min, true);
+    const int last = level_bound(cat->by_level, count, max, false);
+    const int nan_first = level_bound(cat->by_level, count, INFINITY, false);
+    const int in_range = last > first ? last - first : 0;
+
+    Book** matches = malloc((in_range + count - nan_first + 1) * sizeof(Book*));
+    if (matches == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
 
-    sort_catalog(cat, compareByLevel);
-    listCatalog(cat, list_level_predicate, vec.data);
+    memcpy(matches, cat->by_level + first, in_range * sizeof(Book*));
+    memcpy(matches + in_range,
+           cat->by_level + nan_first,
+           (count - nan_first) * sizeof(Book*));
+    list_books(
+      matches, in_range + count - nan_first, list_all_predicate, NULL);
 
-    vector_destroy(&vec);
+    free(matches);
+}
+
+/**
+ * @brief close up the places deleted books left empty in a reading list,
+ * keeping the order of the rest
+ * @param reading_list to close up
+ */
+static void
+close_up_books(Catalog* reading_list)
+{
+    Vector* books = &reading_list->books;
+    int kept = 0;
+
+    for (int i = 0; i < books->size; i++) {
+        Book* book = *(Book**) vector_get(books, i);
+
+        if (book != NULL) {
+            book_map_find(&reading_list->ids, book->id)->position = kept;
+            vector_set(books, kept, &book);
+            kept += 1;
+        }
+    }
+    books->size = kept;
+    reading_list->removed = 0;
 }
 
 /**
@@ -435,6 +534,7 @@ listReadingList(Catalog* cat)
     double level_sum = 0;
     int words_sum = 0;
 
+    close_up_books(cat);
     for (int i = 0; i < cat->books.size; i++) {
         Book* book = *(Book**) vector_get(&cat->books, i);
         level_sum += book->level;
@@ -450,49 +550,24 @@ listReadingList(Catalog* cat)
     printf(footer, level_sum / size, words_sum);
 }
 
+/**
+ * @brief list catalog static, print any selected books
+ * @param cat catalog
+ * @param test function
+ * @param data of books to print
+ */
 void
 listCatalog(Catalog* cat,
             bool (*test)(Book const* book, void const* data),
             void const* data)
 {
-    const char* header = "   ID                                  Title         "
-                         "      Author Level   Words\n";
-
-    const char* fmt_string = "%5d %38s %20s %5.1lf %7d\n";
-
-    int print_count = 0;
-
-    for (int i = 0; i < cat->books.size; i++) {
-        Book* book = *(Book**) vector_get(&cat->books, i);
-        bool to_print = test(book, data);
-
-        print_count = to_print ? print_count + 1 : print_count;
-    }
-
-    if (print_count == 0) {
-        printf("No matching books\n");
-    } else {
-        printf("%s", header);
-
-        for (int i = 0; i < cat->books.size; i++) {
-            Book* book = *(Book**) vector_get(&cat->books, i);
-
-            bool to_print = test(book, data);
-
-            if (to_print) {
-                printf(fmt_string,
-                       book->id,
-                       book->title,
-                       book->author,
-                       book->level,
-                       book->words);
-            }
-        }
-    }
+    list_books(cat->books.data, cat->books.size, test, data);
 }
 
 /**
- * @brief delete a book from a reading list catalog
+ * @brief delete a book from a reading list catalog. its place in books is
+ * emptied rather than closed up, and the list is only closed up once it has
+ * more empty places than books, so a delete costs O(1) amortized
  * @param reading_list to delete a book from
  * @param id_num of book to delete
  * @return deleted book
@@ -500,23 +575,23 @@ listCatalog(Catalog* cat,
 Book*
 deleteBook(Catalog* reading_list, int id_num)
 {
-    int remove_ix = -1;
-
-    for (int i = 0; i < reading_list->books.size; i++) {
-        Book* book = *(Book**) vector_get(&reading_list->books, i);
-
-        if (book->id == id_num) {
-            remove_ix = i;
-            break;
-        }
-    }
+    BookSlot* slot = book_map_find(&reading_list->ids, id_num);
 
-    if (remove_ix > -1) {
-        return vector_remove(&reading_list->books, remove_ix);
-    } else {
+    if (slot == NULL) {
         printf("Book %d is not on the reading list\n", id_num);
         return NULL;
     }
+
+    Book* book = slot->book;
+    Book* empty = NULL;
+    vector_set(&reading_list->books, slot->position, &empty);
+    book_map_remove(&reading_list->ids, id_num);
+    reading_list->removed += 1;
+
+    if (reading_list->removed > reading_list->ids.size) {
+        close_up_books(reading_list);
+    }
+    return book;
 }
 
 /**
@@ -532,9 +607,11 @@ addBook(Catalog* cat, Catalog* reading_list, int id_num)
     if (book == NULL) {
         printf("Book %d is not in the catalog\n", id_num);
     } else {
-        if (get_book_by_id(reading_list, id_num) != NULL) {
+        if (!book_map_put(&reading_list->ids, id_num, book)) {
             printf("Book %d is already on the reading list\n", id_num);
         } else {
+            book_map_find(&reading_list->ids, id_num)->position =
+              reading_list->books.size;
             vector_push(&reading_list->books, &book);
         }
     }
@@ -9,7 +9,9 @@
 #ifndef catalog_h
 #define catalog_h
 
+#include "bookmap.h"
 #include "input.h"
+#include "subject.h"
 #include "vector/vector.h"
 
 #include <stdbool.h>
@@ -40,7 +42,7 @@
 /**
  * Book struct consisting of an ID, titile, author, level and word count
  */
-typedef struct {
+typedef struct Book {
     int id;
     char title[TITLE_LENGTH + 1]; // stores 38 + 1 for null terminator
     char author[AUTHOR_LENGTH + 1];
@@ -50,10 +52,24 @@ typedef struct {
 } Book;
 
 /**
- * Catalog of books
+ * Catalog of books, in the order they were added, and an index of them by id.
+ * by_id and by_level hold the books sorted by id and by level then id, and
+ * subjects indexes the subjects of by_id, built the first time they are
+ * needed after books are read. a catalog opened from a snapshot keeps its
+ * books, ids and subjects in the mapped snapshot, and is NULL otherwise.
+ * a book deleted from a reading list leaves NULL in books, counted by
+ * removed, until the list is closed up
  */
 typedef struct {
     Vector books;
+    int removed;
+    BookMap ids;
+    Book** by_id;
+    Book** by_level;
+    SubjectIndex subjects;
+    bool indexed;
+    void* snapshot;
+    size_t snapshot_size;
 } Catalog;
 
 /**
@@ -78,6 +94,24 @@ freeCatalog(Catalog* cat);
 void
 readCatalog(Catalog* cat, char const* filename);
 
+/**
+ * @brief read books into catalog from several files, reading the files at
+ * the same time
+ * @param cat to read books into
+ * @param filenames of book information
+ * @param count of files
+ */
+void
+readCatalogs(Catalog* cat, char const* const filenames[], int count);
+
+/**
+ * @brief sort the books of the catalog by id and by level and index their
+ * subjects, if they have changed since they were last indexed
+ * @param cat catalog to index
+ */
+void
+indexCatalog(Catalog* cat);
+
 /**
  * @brief list all books in the catalog
  * @param cat catalog of books to list
@@ -131,6 +165,11 @@ strdup2(const char* src);
 Vector
 strsplit2(char* line, char* delimiter);
 
+/**
+ * @brief list the books whose subject contains some text
+ * @param cat catalog of books
+ * @param subject text to look for
+ */
 void
 listSubject(Catalog* cat, char const* subject);
 
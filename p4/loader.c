@@ -0,0 +1,384 @@
+/**
+ * @file loader.c
+ * @author Mike Babb
+ * @author Sanjana Cheerla
+ * @brief read the books of a book list, parsing the fields where they lie in
+ * the file
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "loader.h"
+
+#include "catalog.h"
+#include "scan.h"
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * number of fields every book has
+ */
+#define BOOK_VAL 5
+
+/**
+ * 2nd field of book
+ */
+#define AUTHOR 2
+
+/**
+ * 3rd field of book
+ */
+#define LEVEL 3
+
+/**
+ * 4th field of book
+ */
+#define WORDS 4
+
+/**
+ * most fields looked at, one more than a book with a subject has
+ */
+#define MAX_FIELDS 7
+
+/**
+ * size of each block read from a file that can't be mapped
+ */
+#define READ_SIZE 65536
+
+/**
+ * lists shared by the threads of load_lists, each taking the next one to
+ * read until there are none left
+ */
+typedef struct {
+    BookList* lists;
+    int count;
+    int next;
+    pthread_mutex_t lock;
+} LoadQueue;
+
+/**
+ * field of a line, from start to one before end
+ */
+typedef struct {
+    char const* start;
+    char const* end;
+} Field;
+
+/**
+ * @brief read a whole file into memory, for files that can't be mapped
+ * @param fp to read
+ * @param size receives the number of bytes read
+ * @return the bytes, followed by a null, or NULL if they can't be read
+ */
+static char*
+read_file(FILE* fp, size_t* size)
+{
+    size_t capacity = READ_SIZE;
+    size_t used = 0;
+    char* buffer = malloc(capacity + 1);
+
+    while (buffer != NULL) {
+        if (used == capacity) {
+            capacity *= 2;
+            char* t_buffer = realloc(buffer, capacity + 1);
+            if (t_buffer == NULL) {
+                free(buffer);
+                return NULL;
+            }
+            buffer = t_buffer;
+        }
+
+        size_t count = fread(buffer + used, 1, capacity - used, fp);
+        used += count;
+
+        if (count == 0) {
+            break;
+        }
+    }
+
+    if (buffer == NULL || ferror(fp)) {
+        free(buffer);
+        return NULL;
+    }
+    buffer[used] = '\0';
+    *size = used;
+    return buffer;
+}
+
+/**
+ * @brief split a line into the fields between its tabs. runs of tabs count as
+ * one and a null ends the line early, as with strtok
+ * @param line start of the line
+ * @param end of the line, at its newline
+ * @param fields receives the fields, room for MAX_FIELDS
+ * @return number of fields, MAX_FIELDS if there are that many or more
+ */
+static int
+split_fields(char const* line, char const* end, Field fields[])
+{
+    int count = 0;
+
+    while (count < MAX_FIELDS) {
+        while (line < end && *line == '\t') {
+            line++;
+        }
+        if (line == end) {
+            break;
+        }
+
+        char const* stop = scan_find(line, end, '\t', '\0');
+        fields[count].start = line;
+        fields[count].end = stop;
+        count += 1;
+
+        if (stop < end && *stop == '\0') {
+            break;
+        }
+        line = stop;
+    }
+    return count;
+}
+
+/**
+ * @brief parse a number at the start of a field
+ * @param field to parse
+ * @param value receives the number
+ * @return true if the field starts with a number, false otherwise
+ */
+static bool
+parse_number(Field field, double* value)
+{
+    char const* start = field.start;
+    char* end;
+
+    // A number is always followed by a tab or newline, so strtod stops
+    // inside the field. Anything else, like leading spaces that strtod would
+    // skip into the next field, is parsed from a copy.
+    if (isdigit((unsigned char) *start) || *start == '-' || *start == '+' ||
+        *start == '.') {
+        *value = strtod(start, &end);
+        return end != start;
+    }
+
+    char* copy = strndup(start, field.end - start);
+    if (copy == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    *value = strtod(copy, &end);
+
+    const bool parsed = end != copy;
+    free(copy);
+    return parsed;
+}
+
+/**
+ * @brief copy a field into a fixed size string, ending it with dots when it is
+ * too long
+ * @param dest room for max letters and a null
+ * @param field to copy
+ * @param max letters to keep
+ */
+static void
+copy_clamped(char* dest, Field field, size_t max)
+{
+    size_t length = field.end - field.start;
+
+    if (length > max) {
+        length = max - DOTS_LEN;
+        memcpy(dest, field.start, length);
+        strcpy(dest + length, DOTS);
+    } else {
+        memcpy(dest, field.start, length);
+        dest[length] = '\0';
+    }
+}
+
+/**
+ * @brief make a book from a line of a book list
+ * @param line start of the line
+ * @param end of the line, at its newline
+ * @return the book, or NULL if the line isn't one
+ */
+static Book*
+parse_book(char const* line, char const* end)
+{
+    Field fields[MAX_FIELDS];
+    const int count = split_fields(line, end, fields);
+    double id;
+    double level;
+    double words;
+
+    if (count < BOOK_VAL || !parse_number(fields[0], &id) ||
+        !parse_number(fields[LEVEL], &level) ||
+        !parse_number(fields[WORDS], &words)) {
+        return NULL;
+    }
+
+    Book* book = (Book*) malloc(sizeof(Book));
+    if (book == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    book->id = (int) id;
+    copy_clamped(book->title, fields[1], TITLE_LENGTH);
+    copy_clamped(book->author, fields[AUTHOR], AUTHOR_LENGTH);
+    book->level = level;
+    book->words = (int) words;
+
+    // Only a line with exactly one more field has a subject.
+    if (count == BOOK_VAL + 1) {
+        Field subject = fields[BOOK_VAL];
+        book->subject = strndup(subject.start, subject.end - subject.start);
+    } else {
+        book->subject = NULL;
+    }
+
+    return book;
+}
+
+/**
+ * @brief read the books of a book list, up to the first empty line. regular
+ * files are mapped and parsed in place, so the only copies made are the
+ * fields of each book
+ * @param filename of the book list
+ * @param books receives a pointer to each book, in the order of the list.
+ * when a line is invalid, the books before it
+ * @return LOAD_OK, LOAD_CANT_OPEN if the file can't be opened or read, or
+ * LOAD_INVALID if a line isn't a book
+ */
+LoadStatus
+load_books(char const* filename, Vector* books)
+{
+    FILE* fp = fopen(filename, "r");
+
+    if (fp == NULL) {
+        return LOAD_CANT_OPEN;
+    }
+
+    struct stat st;
+    char* data = NULL;
+    size_t size = 0;
+    bool mapped = false;
+
+    // A file that doesn't end in a newline is read instead, so the null
+    // after it stops strtod on the last field.
+    if (fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode) &&
+        st.st_size > 0) {
+        void* map =
+          mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+
+        if (map != MAP_FAILED && ((char*) map)[st.st_size - 1] == '\n') {
+            data = map;
+            size = st.st_size;
+            mapped = true;
+        } else if (map != MAP_FAILED) {
+            munmap(map, st.st_size);
+        }
+    }
+
+    if (!mapped) {
+        data = read_file(fp, &size);
+    }
+    fclose(fp);
+
+    if (data == NULL) {
+        return LOAD_CANT_OPEN;
+    }
+
+    LoadStatus status = LOAD_OK;
+    char const* end = data + size;
+
+    // An empty line ends the list.
+    for (char const* line = data; line < end && *line != '\n';) {
+        char const* line_end = scan_find(line, end, '\n', '\n');
+        Book* book = parse_book(line, line_end);
+
+        if (book == NULL) {
+            status = LOAD_INVALID;
+            break;
+        }
+        vector_push(books, &book);
+        line = line_end + 1;
+    }
+
+    if (mapped) {
+        munmap(data, size);
+    } else {
+        free(data);
+    }
+    return status;
+}
+
+/**
+ * @brief read lists from the queue until they have all been taken
+ * @param arg the queue
+ * @return NULL
+ */
+static void*
+load_worker(void* arg)
+{
+    LoadQueue* queue = arg;
+
+    while (true) {
+        pthread_mutex_lock(&queue->lock);
+        const int ix = queue->next;
+        queue->next += 1;
+        pthread_mutex_unlock(&queue->lock);
+
+        if (ix >= queue->count) {
+            return NULL;
+        }
+
+        BookList* list = &queue->lists[ix];
+        list->status = load_books(list->filename, &list->books);
+    }
+}
+
+/**
+ * @brief read several book lists at once, one per thread, with as many
+ * threads as there are processors
+ * @param lists to read, with their filename set. each receives its books and
+ * status as from load_books
+ * @param count of lists
+ */
+void
+load_lists(BookList lists[], int count)
+{
+    LoadQueue queue = {.lists = lists, .count = count, .next = 0};
+    pthread_mutex_init(&queue.lock, NULL);
+
+    for (int i = 0; i < count; i++) {
+        lists[i].books = vector_create(sizeof(Book*));
+    }
+
+    // The calling thread reads lists too, so one list needs no threads.
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = threads < count ? threads : count;
+    threads = threads > 1 ? threads - 1 : 0;
+
+    pthread_t* workers = malloc((threads + 1) * sizeof(pthread_t));
+    int started = 0;
+
+    while (workers != NULL && started < threads &&
+           pthread_create(&workers[started], NULL, load_worker, &queue) == 0) {
+        started += 1;
+    }
+
+    load_worker(&queue);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+    pthread_mutex_destroy(&queue.lock);
+}
@@ -0,0 +1,55 @@
+/**
+ * @file loader.h
+ * @author Mike Babb
+ * @author Sanjana Cheerla
+ * @brief read the books of a book list, parsing the fields where they lie in
+ * the file
+ */
+
+#ifndef loader_h
+#define loader_h
+
+#include "vector/vector.h"
+
+/**
+ * how reading a book list went
+ */
+typedef enum {
+    LOAD_OK,
+    LOAD_CANT_OPEN,
+    LOAD_INVALID
+} LoadStatus;
+
+/**
+ * book list read by load_lists, and how reading it went
+ */
+typedef struct {
+    char const* filename;
+    Vector books;
+    LoadStatus status;
+} BookList;
+
+/**
+ * @brief read the books of a book list, up to the first empty line. regular
+ * files are mapped and parsed in place, so the only copies made are the
+ * fields of each book
+ * @param filename of the book list
+ * @param books receives a pointer to each book, in the order of the list.
+ * when a line is invalid, the books before it
+ * @return LOAD_OK, LOAD_CANT_OPEN if the file can't be opened or read, or
+ * LOAD_INVALID if a line isn't a book
+ */
+LoadStatus
+load_books(char const* filename, Vector* books);
+
+/**
+ * @brief read several book lists at once, one per thread, with as many
+ * threads as there are processors
+ * @param lists to read, with their filename set. each receives its books and
+ * status as from load_books
+ * @param count of lists
+ */
+void
+load_lists(BookList lists[], int count);
+
+#endif /* loader_h */
@@ -6,6 +6,7 @@
  */
 #include "catalog.h"
 #include "input.h"
+#include "snapshot.h"
 #include "vector/vector.h"
 
 #include <assert.h>
@@ -18,6 +19,16 @@
  */
 #define VALID_COMMAND_COUNT 2
 
+/**
+ * option to save the catalog as a snapshot instead of reading commands
+ */
+#define COMPILE_ARG "--compile"
+
+/**
+ * option naming the snapshot to save
+ */
+#define OUTPUT_ARG "-o"
+
 /**
  * @brief prints invalid command
  */
@@ -27,6 +38,48 @@ printInvalidCommand()
     printf("Invalid command\n");
 }
 
+/**
+ * @brief read the book lists of the command line and save them as a snapshot
+ * @param argc for number of arguments
+ * @param argv of arguments: --compile, the book lists and -o snapshot
+ * @return 0 if the snapshot was saved, 1 otherwise
+ */
+static int
+compile(int argc, const char* argv[])
+{
+    const char* output = NULL;
+    const char** lists = malloc(argc * sizeof(char*));
+    int list_count = 0;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], OUTPUT_ARG) == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            lists[list_count++] = argv[i];
+        }
+    }
+
+    if (output == NULL || list_count == 0) {
+        fprintf(stderr, "usage: reading --compile <book-list>* -o <file>\n");
+        free(lists);
+        return 1;
+    }
+
+    Catalog* cat = makeCatalog();
+
+    readCatalogs(cat, lists, list_count);
+    indexCatalog(cat);
+    free(lists);
+
+    const bool written = snapshot_write(cat, output);
+    if (!written) {
+        fprintf(stderr, "Can't write file: %s\n", output);
+    }
+
+    freeCatalog(cat);
+    return written ? 0 : 1;
+}
+
 /**
  * @brief main program
  * @param argc for number of arguments
@@ -41,12 +94,19 @@ main(int argc, const char* argv[])
         exit(1);
     }
 
-    Catalog* cat = makeCatalog();
+    if (strcmp(argv[1], COMPILE_ARG) == 0) {
+        exit(compile(argc, argv));
+    }
+
+    // A single snapshot is mapped, anything else is read as book lists.
+    Catalog* cat = argc == 2 ? snapshot_open(argv[1]) : NULL;
     Catalog* reading_list = makeCatalog();
 
-    for (int i = 1; i < argc; i++) {
-        readCatalog(cat, argv[i]);
+    if (cat == NULL) {
+        cat = makeCatalog();
+        readCatalogs(cat, argv + 1, argc - 1);
     }
+    indexCatalog(cat);
 
     int i = 0;
 
@@ -147,6 +207,8 @@ main(int argc, const char* argv[])
 
     freeCatalog(cat);
     vector_destroy(&reading_list->books);
+    book_map_destroy(&reading_list->ids);
+    subject_index_destroy(&reading_list->subjects);
     free(reading_list);
 
     exit(0);
@@ -0,0 +1,92 @@
+/**
+ * @file scan.c
+ * @author Mike Babb
+ * @author Sanjana Cheerla
+ * @brief find tabs and newlines in a book list a 64 byte block at a time
+ */
+
+#include "scan.h"
+
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * bytes compared per block, one bit each in a block mask
+ */
+#define BLOCK 64
+
+/**
+ * @brief compare a block of BLOCK bytes against a and b. uses AVX2 when built
+ * with -mavx2, SSE2 on any other x86-64 build and plain compares elsewhere
+ * @param p start of the block
+ * @param a byte to find
+ * @param b other byte to find
+ * @return bit i set if byte i is a or b
+ */
+static inline uint64_t
+block_mask(char const* p, char a, char b)
+{
+#if defined(__AVX2__)
+    const __m256i va = _mm256_set1_epi8(a);
+    const __m256i vb = _mm256_set1_epi8(b);
+    uint64_t mask = 0;
+
+    for (int k = 0; k < BLOCK; k += 32) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*) (p + k));
+        const __m256i eq =
+          _mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb));
+        mask |= (uint64_t) (uint32_t) _mm256_movemask_epi8(eq) << k;
+    }
+    return mask;
+#elif defined(__SSE2__)
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    uint64_t mask = 0;
+
+    for (int k = 0; k < BLOCK; k += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i*) (p + k));
+        const __m128i eq =
+          _mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb));
+        mask |= (uint64_t) (uint16_t) _mm_movemask_epi8(eq) << k;
+    }
+    return mask;
+#else
+    uint64_t mask = 0;
+
+    for (int k = 0; k < BLOCK; k++) {
+        mask |= (uint64_t) (p[k] == a || p[k] == b) << k;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * @brief find the first byte equal to a or b. pass the same byte twice to
+ * look for just one
+ * @param data start of the bytes
+ * @param end one past the last byte
+ * @param a byte to find, such as a newline
+ * @param b other byte to find, such as a tab
+ * @return the first match, or end if there is none
+ */
+char const*
+scan_find(char const* data, char const* end, char a, char b)
+{
+    for (; end - data >= BLOCK; data += BLOCK) {
+        const uint64_t mask = block_mask(data, a, b);
+        if (mask != 0) {
+            return data + __builtin_ctzll(mask);
+        }
+    }
+    for (; data < end; data++) {
+        if (*data == a || *data == b) {
+            return data;
+        }
+    }
+    return end;
+}
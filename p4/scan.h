@@ -0,0 +1,25 @@
+/**
+ * @file scan.h
+ * @author Mike Babb
+ * @author Sanjana Cheerla
+ * @brief find tabs and newlines in a book list a 64 byte block at a time
+ */
+
+#ifndef scan_h
+#define scan_h
+
+#include <stddef.h>
+
+/**
+ * @brief find the first byte equal to a or b. pass the same byte twice to
+ * look for just one
+ * @param data start of the bytes
+ * @param end one past the last byte
+ * @param a byte to find, such as a newline
+ * @param b other byte to find, such as a tab
+ * @return the first match, or end if there is none
+ */
+char const*
+scan_find(char const* data, char const* end, char a, char b);
+
+#endif /* scan_h */
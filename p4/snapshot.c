@@ -0,0 +1,442 @@
+/**
+ * @file snapshot.c
+ * @author Mike Babb
+ * @author Sanjana Cheerla
+ * @brief save a catalog with its indexes to a file that can be mapped and
+ * used without reading the book lists again
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "snapshot.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * first bytes of every snapshot
+ */
+#define SNAPSHOT_MAGIC "BOOKSNAP"
+
+/**
+ * length of the magic, without a null
+ */
+#define MAGIC_LENGTH 8
+
+/**
+ * version of the layout below, changed whenever it changes
+ */
+#define SNAPSHOT_VERSION 1
+
+/**
+ * sections start at multiples of this many bytes
+ */
+#define SECTION_ALIGN 8
+
+/**
+ * start of a snapshot. after it come, each section padded to SECTION_ALIGN:
+ * the books in order of id, with the subject replaced by one more than its
+ * offset in the heap (0 for none); the position of each book in order of
+ * level; the id index, with each book replaced by one more than its position;
+ * the trigram slots and postings of the subject index; and the heap of
+ * subjects, each ended by a null. book_size catches a snapshot saved by a
+ * build with a different Book
+ */
+typedef struct {
+    char magic[MAGIC_LENGTH];
+    uint32_t version;
+    uint32_t book_size;
+    uint64_t count;
+    uint64_t map_capacity;
+    uint64_t trigram_capacity;
+    uint64_t posting_count;
+    uint64_t heap_size;
+} SnapshotHeader;
+
+/**
+ * where each section of a snapshot starts, from the start of the file
+ */
+typedef struct {
+    size_t books;
+    size_t levels;
+    size_t map;
+    size_t trigrams;
+    size_t postings;
+    size_t heap;
+    size_t end;
+} SnapshotLayout;
+
+/**
+ * @brief round a size up to a whole number of SECTION_ALIGN
+ * @param size to round
+ * @return rounded size
+ */
+static size_t
+align(size_t size)
+{
+    return (size + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+}
+
+/**
+ * @brief work out where the sections of a snapshot start
+ * @param header of the snapshot
+ * @return the layout
+ */
+static SnapshotLayout
+layout(const SnapshotHeader* header)
+{
+    SnapshotLayout at;
+
+    at.books = align(sizeof(SnapshotHeader));
+    at.levels = at.books + align(header->count * sizeof(Book));
+    at.map = at.levels + align(header->count * sizeof(int32_t));
+    at.trigrams = at.map + align(header->map_capacity * sizeof(BookSlot));
+    at.postings =
+      at.trigrams + align(header->trigram_capacity * sizeof(TrigramSlot));
+    at.heap = at.postings + align(header->posting_count * sizeof(int));
+    at.end = at.heap + header->heap_size;
+    return at;
+}
+
+/**
+ * @brief find where a book is in order of id
+ * @param cat catalog, indexed
+ * @param id of the book
+ * @return the position
+ */
+static int
+position_of(Catalog* cat, int id)
+{
+    int lo = 0;
+    int hi = cat->books.size - 1;
+
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+
+        if (cat->by_id[mid]->id < id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief write the padding after a section
+ * @param fp to write to
+ * @param size of the section
+ * @return true if the padding was written
+ */
+static bool
+write_padding(FILE* fp, size_t size)
+{
+    const char padding[SECTION_ALIGN] = {0};
+
+    return fwrite(padding, 1, align(size) - size, fp) == align(size) - size;
+}
+
+/**
+ * @brief write bytes followed by the padding to the next section
+ * @param fp to write to
+ * @param data to write
+ * @param size of data
+ * @return true if everything was written
+ */
+static bool
+write_section(FILE* fp, const void* data, size_t size)
+{
+    return fwrite(data, 1, size, fp) == size && write_padding(fp, size);
+}
+
+/**
+ * @brief save a catalog as a snapshot
+ * @param cat to save, indexed
+ * @param filename of the snapshot
+ * @return true if the snapshot was written, false otherwise
+ */
+bool
+snapshot_write(Catalog* cat, char const* filename)
+{
+    const int count = cat->books.size;
+    SnapshotHeader header = {.version = SNAPSHOT_VERSION,
+                             .book_size = sizeof(Book),
+                             .count = count,
+                             .map_capacity = cat->ids.capacity,
+                             .trigram_capacity = cat->subjects.capacity,
+                             .posting_count = 0,
+                             .heap_size = 0};
+    memcpy(header.magic, SNAPSHOT_MAGIC, MAGIC_LENGTH);
+
+    for (int i = 0; i < cat->subjects.capacity; i++) {
+        header.posting_count += cat->subjects.slots[i].count;
+    }
+    for (int i = 0; i < count; i++) {
+        char const* subject = cat->by_id[i]->subject;
+        header.heap_size += subject != NULL ? strlen(subject) + 1 : 0;
+    }
+
+    FILE* fp = fopen(filename, "wb");
+    if (fp == NULL) {
+        return false;
+    }
+
+    bool written = write_section(fp, &header, sizeof(header));
+
+    uint64_t heap_used = 0;
+    for (int i = 0; i < count && written; i++) {
+        const Book* book = cat->by_id[i];
+        Book record;
+
+        // Zeroed first, so the padding and the bytes past each string are
+        // written as zeros rather than whatever the heap held.
+        memset(&record, 0, sizeof(record));
+        record.id = book->id;
+        strncpy(record.title, book->title, TITLE_LENGTH);
+        strncpy(record.author, book->author, AUTHOR_LENGTH);
+        record.level = book->level;
+        record.words = book->words;
+
+        if (book->subject != NULL) {
+            record.subject = (char*) (uintptr_t) (heap_used + 1);
+            heap_used += strlen(book->subject) + 1;
+        }
+        written = fwrite(&record, sizeof(record), 1, fp) == 1;
+    }
+    written = written && write_padding(fp, count * sizeof(Book));
+
+    for (int i = 0; i < count && written; i++) {
+        const int32_t position = position_of(cat, cat->by_level[i]->id);
+        written = fwrite(&position, sizeof(position), 1, fp) == 1;
+    }
+    written = written && write_padding(fp, count * sizeof(int32_t));
+
+    for (int i = 0; i < cat->ids.capacity && written; i++) {
+        BookSlot slot = cat->ids.slots[i];
+
+        if (slot.book != NULL) {
+            const int position = position_of(cat, slot.id);
+            slot.book = (struct Book*) (uintptr_t) (position + 1);
+        }
+        written = fwrite(&slot, sizeof(slot), 1, fp) == 1;
+    }
+
+    written = written &&
+              write_section(fp,
+                            cat->subjects.slots,
+                            cat->subjects.capacity * sizeof(TrigramSlot)) &&
+              write_section(fp,
+                            cat->subjects.postings,
+                            header.posting_count * sizeof(int));
+
+    for (int i = 0; i < count && written; i++) {
+        char const* subject = cat->by_id[i]->subject;
+
+        if (subject != NULL) {
+            written = fwrite(subject, strlen(subject) + 1, 1, fp) == 1;
+        }
+    }
+
+    // Closing flushes the last of the writes, which can fail too.
+    return fclose(fp) == 0 && written;
+}
+
+/**
+ * @brief whether a capacity is a power of two, as the hash tables need
+ * @param capacity to check
+ * @return true if it is
+ */
+static bool
+power_of_two(uint64_t capacity)
+{
+    return capacity > 0 && (capacity & (capacity - 1)) == 0;
+}
+
+/**
+ * @brief point the books and indexes of a mapped snapshot at each other and
+ * check that they stay inside it. each posting list must name books in
+ * increasing order, as the subject search assumes
+ * @param cat catalog with the mapped snapshot
+ * @param header of the snapshot
+ * @param at layout of the snapshot
+ * @return true if the snapshot is sound
+ */
+static bool
+link_snapshot(Catalog* cat, const SnapshotHeader* header, SnapshotLayout at)
+{
+    char* base = cat->snapshot;
+    Book* records = (Book*) (base + at.books);
+    const int32_t* levels = (const int32_t*) (base + at.levels);
+    char const* heap = base + at.heap;
+    const int count = header->count;
+
+    if (header->heap_size > 0 && heap[header->heap_size - 1] != '\0') {
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        Book* book = &records[i];
+        const uintptr_t offset = (uintptr_t) book->subject;
+
+        if (offset > header->heap_size) {
+            return false;
+        }
+        book->subject = offset > 0 ? (char*) heap + offset - 1 : NULL;
+        book->title[TITLE_LENGTH] = '\0';
+        book->author[AUTHOR_LENGTH] = '\0';
+
+        vector_push(&cat->books, &book);
+        cat->by_id[i] = book;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (levels[i] < 0 || levels[i] >= count) {
+            return false;
+        }
+        cat->by_level[i] = &records[levels[i]];
+    }
+
+    int filled = 0;
+    for (uint64_t i = 0; i < header->map_capacity; i++) {
+        BookSlot* slot = &cat->ids.slots[i];
+        const uintptr_t position = (uintptr_t) slot->book;
+
+        if (position > (uintptr_t) count ||
+            (position > 0 && records[position - 1].id != slot->id)) {
+            return false;
+        }
+        slot->book = position > 0 ? &records[position - 1] : NULL;
+        filled += position > 0;
+    }
+    if (filled != count || (uint64_t) filled * 2 > header->map_capacity) {
+        return false;
+    }
+
+    filled = 0;
+    for (uint64_t i = 0; i < header->trigram_capacity; i++) {
+        const TrigramSlot* slot = &cat->subjects.slots[i];
+
+        if (slot->start < 0 || slot->count < 0 ||
+            (uint64_t) slot->start + slot->count > header->posting_count) {
+            return false;
+        }
+
+        const int* postings = cat->subjects.postings + slot->start;
+        for (int j = 0; j < slot->count; j++) {
+            if (postings[j] < 0 || postings[j] >= count ||
+                (j > 0 && postings[j] <= postings[j - 1])) {
+                return false;
+            }
+        }
+        filled += slot->key != 0;
+    }
+    return (uint64_t) filled < header->trigram_capacity;
+}
+
+/**
+ * @brief map a snapshot as a catalog, exiting if it is damaged or was saved
+ * by a different version. the books and indexes are used where they lie in
+ * the mapping, only their pointers are set
+ * @param filename of the snapshot
+ * @return the catalog, or NULL if the file isn't a regular file starting
+ * with the snapshot magic
+ */
+Catalog*
+snapshot_open(char const* filename)
+{
+    SnapshotHeader header;
+    struct stat st;
+
+    // Only a regular file can be a snapshot. Anything else, like a pipe,
+    // is left unopened, since what is read from it to check couldn't be
+    // read again as a book list.
+    if (stat(filename, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return NULL;
+    }
+
+    FILE* fp = fopen(filename, "r");
+
+    if (fp == NULL) {
+        return NULL;
+    }
+    if (fstat(fileno(fp), &st) != 0 || !S_ISREG(st.st_mode) ||
+        fread(&header, sizeof(header), 1, fp) != 1 ||
+        memcmp(header.magic, SNAPSHOT_MAGIC, MAGIC_LENGTH) != 0) {
+        fclose(fp);
+        return NULL;
+    }
+
+    // Every count is at most the size of the file, so the layout can't
+    // overflow.
+    const uint64_t size = st.st_size;
+    const bool fits = header.count <= size && header.count < INT32_MAX &&
+                      header.map_capacity <= size &&
+                      header.trigram_capacity <= size &&
+                      header.posting_count <= size && header.heap_size <= size;
+    const SnapshotLayout at = layout(&header);
+
+    if (header.version != SNAPSHOT_VERSION ||
+        header.book_size != sizeof(Book) || !fits || at.end != size ||
+        !power_of_two(header.map_capacity) ||
+        !power_of_two(header.trigram_capacity)) {
+        goto invalid;
+    }
+
+    // Private and writable, so the pointers set in it stay in this process.
+    void* map =
+      mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(fp), 0);
+    if (map == MAP_FAILED) {
+        goto invalid;
+    }
+
+    char* base = map;
+    Catalog* cat = (Catalog*) malloc(sizeof(Catalog));
+    cat->books = vector_create(sizeof(Book*));
+    cat->removed = 0;
+    cat->ids.slots = (BookSlot*) (base + at.map);
+    cat->ids.size = header.count;
+    cat->ids.capacity = header.map_capacity;
+    cat->by_id = malloc((header.count + 1) * sizeof(Book*));
+    cat->by_level = malloc((header.count + 1) * sizeof(Book*));
+    cat->subjects.slots = (TrigramSlot*) (base + at.trigrams);
+    cat->subjects.capacity = header.trigram_capacity;
+    cat->subjects.postings = (int*) (base + at.postings);
+    cat->indexed = true;
+    cat->snapshot = map;
+    cat->snapshot_size = size;
+
+    if (cat->by_id == NULL || cat->by_level == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    if (!link_snapshot(cat, &header, at)) {
+        snapshot_close(cat);
+        goto invalid;
+    }
+
+    fclose(fp);
+    return cat;
+
+invalid:
+    fprintf(stderr, "Invalid snapshot: %s\n", filename);
+    fclose(fp);
+    exit(1);
+}
+
+/**
+ * @brief unmap the snapshot of a catalog and free the catalog
+ * @param cat opened with snapshot_open
+ */
+void
+snapshot_close(Catalog* cat)
+{
+    munmap(cat->snapshot, cat->snapshot_size);
+    vector_destroy(&cat->books);
+    free(cat->by_id);
+    free(cat->by_level);
+    free(cat);
+}
@@ -0,0 +1,42 @@
+/**
+ * @file snapshot.h
+ * @author Mike Babb
+ * @author Sanjana Cheerla
+ * @brief save a catalog with its indexes to a file that can be mapped and
+ * used without reading the book lists again
+ */
+
+#ifndef snapshot_h
+#define snapshot_h
+
+#include "catalog.h"
+
+#include <stdbool.h>
+
+/**
+ * @brief save a catalog as a snapshot
+ * @param cat to save, indexed
+ * @param filename of the snapshot
+ * @return true if the snapshot was written, false otherwise
+ */
+bool
+snapshot_write(Catalog* cat, char const* filename);
+
+/**
+ * @brief map a snapshot as a catalog, exiting if it is damaged or was saved
+ * by a different version
+ * @param filename of the snapshot
+ * @return the catalog, or NULL if the file isn't a regular file starting
+ * with the snapshot magic
+ */
+Catalog*
+snapshot_open(char const* filename);
+
+/**
+ * @brief unmap the snapshot of a catalog and free the catalog
+ * @param cat opened with snapshot_open
+ */
+void
+snapshot_close(Catalog* cat);
+
+#endif /* snapshot_h */
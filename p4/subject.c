@@ -0,0 +1,301 @@
+/**
+ * @file subject.c
+ * @author Mike Babb
+ * @author Sanjana Cheerla
+ * @brief index of the three letter sequences in book subjects, so books with
+ * a subject containing some text are found without searching every subject
+ */
+
+#include "subject.h"
+
+#include "catalog.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * length of the sequences indexed
+ */
+#define TRIGRAM 3
+
+/**
+ * initial number of slots, a power of two
+ */
+#define INDEX_CAPACITY 1024
+
+/**
+ * 2^32 divided by the golden ratio, mixes the letters of a trigram
+ */
+#define INDEX_MULTIPLIER 2654435769u
+
+/**
+ * @brief the key of the trigram starting at text, never 0 since the letters
+ * of a string aren't
+ * @param text at least three letters long
+ * @return the key
+ */
+static int
+trigram_key(char const* text)
+{
+    const unsigned char* letters = (const unsigned char*) text;
+
+    return letters[0] << 16 | letters[1] << 8 | letters[2];
+}
+
+/**
+ * @brief find the slot holding a key, or the empty slot where it would go
+ * @param slots of the table
+ * @param capacity of the table, a power of two
+ * @param key to look for
+ * @return the slot
+ */
+static TrigramSlot*
+find_slot(TrigramSlot* slots, int capacity, int key)
+{
+    uint32_t hash = (uint32_t) key * INDEX_MULTIPLIER;
+    int ix = (int) ((hash ^ hash >> 16) & (capacity - 1));
+
+    while (slots[ix].key != 0 && slots[ix].key != key) {
+        ix = (ix + 1) & (capacity - 1);
+    }
+    return &slots[ix];
+}
+
+/**
+ * @brief allocate memory, exiting if there is none
+ * @param size in bytes
+ * @return the zeroed memory
+ */
+static void*
+allocate(size_t size)
+{
+    void* data = calloc(1, size > 0 ? size : 1);
+
+    if (data == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return data;
+}
+
+/**
+ * @brief double the number of slots of the index, keeping the counts
+ * @param index to grow
+ */
+static void
+grow(SubjectIndex* index)
+{
+    TrigramSlot* old = index->slots;
+    const int old_capacity = index->capacity;
+
+    index->capacity *= 2;
+    index->slots = allocate(index->capacity * sizeof(TrigramSlot));
+
+    for (int i = 0; i < old_capacity; i++) {
+        if (old[i].key != 0) {
+            *find_slot(index->slots, index->capacity, old[i].key) = old[i];
+        }
+    }
+    free(old);
+}
+
+/**
+ * @brief index the subjects of an array of books. the trigrams are counted
+ * first so each posting list gets its own run of one array, and the books
+ * are then listed in order
+ * @param books to index
+ * @param count of books
+ * @return created index
+ */
+SubjectIndex
+subject_index_create(struct Book* const* books, int count)
+{
+    SubjectIndex index = {
+      .slots = allocate(INDEX_CAPACITY * sizeof(TrigramSlot)),
+      .capacity = INDEX_CAPACITY,
+      .postings = NULL};
+    int used = 0;
+
+    for (int i = 0; i < count; i++) {
+        char const* subject = books[i]->subject;
+
+        for (int j = 0; subject != NULL && subject[j] != '\0' &&
+                        subject[j + 1] != '\0' && subject[j + 2] != '\0';
+             j++) {
+            const int key = trigram_key(&subject[j]);
+            TrigramSlot* slot = find_slot(index.slots, index.capacity, key);
+
+            if (slot->key == 0) {
+                if ((used + 1) * 2 > index.capacity) {
+                    grow(&index);
+                    slot = find_slot(index.slots, index.capacity, key);
+                }
+                slot->key = key;
+                slot->last = -1;
+                used += 1;
+            }
+            if (slot->last != i) {
+                slot->count += 1;
+                slot->last = i;
+            }
+        }
+    }
+
+    int total = 0;
+    for (int i = 0; i < index.capacity; i++) {
+        index.slots[i].start = total;
+        total += index.slots[i].count;
+        index.slots[i].count = 0;
+        index.slots[i].last = -1;
+    }
+    index.postings = allocate(total * sizeof(int));
+
+    for (int i = 0; i < count; i++) {
+        char const* subject = books[i]->subject;
+
+        for (int j = 0; subject != NULL && subject[j] != '\0' &&
+                        subject[j + 1] != '\0' && subject[j + 2] != '\0';
+             j++) {
+            TrigramSlot* slot = find_slot(
+              index.slots, index.capacity, trigram_key(&subject[j]));
+
+            if (slot->last != i) {
+                index.postings[slot->start + slot->count] = i;
+                slot->count += 1;
+                slot->last = i;
+            }
+        }
+    }
+
+    return index;
+}
+
+/**
+ * @brief free an index
+ * @param index to free
+ */
+void
+subject_index_destroy(SubjectIndex* index)
+{
+    free(index->slots);
+    free(index->postings);
+    index->slots = NULL;
+    index->postings = NULL;
+    index->capacity = 0;
+}
+
+/**
+ * @brief find the first posting at least target, looking ahead in growing
+ * steps from lo and then halving the step
+ * @param list of postings in increasing order
+ * @param lo first posting to look at
+ * @param count of postings
+ * @param target posting to look for
+ * @return index of the posting, or count if there is none
+ */
+static int
+seek(const int* list, int lo, int count, int target)
+{
+    int step = 1;
+    int hi = lo;
+
+    while (hi < count && list[hi] < target) {
+        lo = hi + 1;
+        hi += step;
+        step *= 2;
+    }
+    hi = hi < count ? hi : count;
+
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+
+        if (list[mid] < target) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief whether a book's subject contains some text
+ * @param book to check
+ * @param subject text to look for
+ * @return true if it does, false if not or the book has no subject
+ */
+static bool
+has_subject(struct Book const* book, char const* subject)
+{
+    return book->subject != NULL && strstr(book->subject, subject) != NULL;
+}
+
+/**
+ * @brief find the books whose subject contains some text. the books holding
+ * every trigram of the text are found from the index and only those are
+ * searched, text shorter than a trigram is searched for in every subject
+ * @param index of the books
+ * @param books the index was built from
+ * @param count of books
+ * @param subject text to look for
+ * @param matches receives the matching books in order, room for count
+ * @return number of matching books
+ */
+int
+subject_index_find(const SubjectIndex* index,
+                   struct Book* const* books,
+                   int count,
+                   char const* subject,
+                   struct Book** matches)
+{
+    const int length = strlen(subject);
+    int found = 0;
+
+    if (length < TRIGRAM) {
+        for (int i = 0; i < count; i++) {
+            if (has_subject(books[i], subject)) {
+                matches[found++] = books[i];
+            }
+        }
+        return found;
+    }
+
+    // The trigram with the fewest books gives the candidates, the others
+    // only rule them out.
+    const int trigrams = length - TRIGRAM + 1;
+    const TrigramSlot** lists = allocate(trigrams * sizeof(TrigramSlot*));
+    int* cursors = allocate(trigrams * sizeof(int));
+    const TrigramSlot* shortest = NULL;
+
+    for (int j = 0; j < trigrams; j++) {
+        lists[j] = find_slot(
+          index->slots, index->capacity, trigram_key(&subject[j]));
+
+        if (shortest == NULL || lists[j]->count < shortest->count) {
+            shortest = lists[j];
+        }
+    }
+
+    for (int i = 0; i < shortest->count; i++) {
+        const int candidate = index->postings[shortest->start + i];
+        bool listed = true;
+
+        for (int j = 0; j < trigrams && listed; j++) {
+            const int* list = &index->postings[lists[j]->start];
+
+            cursors[j] = seek(list, cursors[j], lists[j]->count, candidate);
+            listed = cursors[j] < lists[j]->count &&
+                     list[cursors[j]] == candidate;
+        }
+
+        if (listed && has_subject(books[candidate], subject)) {
+            matches[found++] = books[candidate];
+        }
+    }
+
+    free(lists);
+    free(cursors);
+    return found;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file subject.h
+ * @author Mike Babb
+ * @author Sanjana Cheerla
+ * @brief index of the three letter sequences in book subjects, so books with
+ * a subject containing some text are found without searching every subject
+ */
+
+#ifndef subject_h
+#define subject_h
+
+/**
+ * forward declaration of the book struct in catalog.h
+ */
+struct Book;
+
+/**
+ * posting list of the books whose subject contains a trigram, empty when key
+ * is 0. last is the last book counted, so a book is only listed once however
+ * often the trigram comes up in its subject
+ */
+typedef struct {
+    int key;
+    int start;
+    int count;
+    int last;
+} TrigramSlot;
+
+/**
+ * open addressing hash table of trigrams, each with a run of postings. the
+ * postings are positions in the array of books the index was built from, in
+ * increasing order
+ */
+typedef struct {
+    TrigramSlot* slots;
+    int capacity;
+    int* postings;
+} SubjectIndex;
+
+/**
+ * @brief index the subjects of an array of books
+ * @param books to index
+ * @param count of books
+ * @return created index
+ */
+SubjectIndex
+subject_index_create(struct Book* const* books, int count);
+
+/**
+ * @brief free an index
+ * @param index to free
+ */
+void
+subject_index_destroy(SubjectIndex* index);
+
+/**
+ * @brief find the books whose subject contains some text. the books holding
+ * every trigram of the text are found from the index and only those are
+ * searched, text shorter than a trigram is searched for in every subject
+ * @param index of the books
+ * @param books the index was built from
+ * @param count of books
+ * @param subject text to look for
+ * @param matches receives the matching books in order, room for count
+ * @return number of matching books
+ */
+int
+subject_index_find(const SubjectIndex* index,
+                   struct Book* const* books,
+                   int count,
+                   char const* subject,
+                   struct Book** matches);
+
+#endif /* subject_h */
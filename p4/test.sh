@@ -105,6 +105,39 @@ if [ -x reading ] ; then
     
     args=(list-g.txt)
     runTest 19 1
+
+    ./reading --compile list-a.txt list-b.txt list-c.txt list-d.txt \
+      -o catalog.bin
+    args=(catalog.bin)
+    runTest 20 0
+
+    args=(--compile list-a.txt)
+    runTest 21 1
+
+    args=(list-a.txt list-z.txt list-g.txt)
+    runTest 22 1
+
+    args=(list-h.txt)
+    runTest 23 0
+
+    # The snapshot of test 20 with every posting set to -1.
+    cp catalog.bin catalog-bad.bin
+    size=$(stat -c %s catalog.bin)
+    postings=$(od -An -t u8 -j 40 -N 8 catalog.bin)
+    heap=$(od -An -t u8 -j 48 -N 8 catalog.bin)
+    head -c $(( postings * 4 )) /dev/zero | tr '\0' '\377' |
+      dd of=catalog-bad.bin bs=1 conv=notrunc 2>/dev/null \
+        seek=$(( size - heap - (postings * 4 + 7) / 8 * 8 ))
+    args=(catalog-bad.bin)
+    runTest 24 1
+
+    # A book list that can only be read once.
+    rm -f list-pipe
+    mkfifo list-pipe
+    cat list-a.txt > list-pipe &
+    args=(list-pipe)
+    runTest 25 0
+    rm -f list-pipe
     
 else
     echo "**** Your program couldn't be tested since it didn't compile successfully."